@@ -0,0 +1,144 @@
+/* Main C++ File for the Evaluation Backends
+	Repo: https://github.com/mimocha/ga-logic-circuit
+	Copyright (c) 2018 Chawit Leosrisook
+*/
+
+/* ========== Standard Library Include ========== */
+
+#include <stddef.h>		// NULL
+#include <stdint.h>		// uint definitions
+
+
+
+/* ========== Custom Header Include ========== */
+
+#include "backend.hpp"
+#include "eval.hpp"
+#include "fpga.hpp"
+#include "global.hpp"
+#include "lca.hpp"
+
+
+
+/* ========== Software Backend ==========
+	The batched Cell Array, one grid per lane.
+*/
+
+class SoftBackend : public Backend {
+
+private:
+
+	BatchCellArray batch;
+
+public:
+
+	const char *get_name (void) { return "Software"; }
+
+	unsigned int get_lanes (void) { return LCA_BATCH; }
+
+	void clear (void) { batch.reset (); }
+
+	// Every lane is cleared anyway -- Nothing to save
+	void replace (void) { batch.reset (); }
+
+	void load_image (const unsigned int &lane, const uint32_t *const image) {
+		batch.set_image (lane, image);
+	}
+
+	void set_cone (const uint64_t &mask) { batch.set_cone (mask); }
+
+	void apply_input (const uint64_t &input) { batch.set_input (input); }
+
+	void step (const uint16_t &cycles) { batch.wind_clock (cycles); }
+
+	uint16_t settle (const uint16_t &limit) { return batch.settle (limit); }
+
+	uint64_t read_output (const unsigned int &lane) { return batch.get_output (lane); }
+
+	bool get_unstable (const unsigned int &lane) { return batch.get_unstable (lane); }
+
+};
+
+
+
+/* ========== Avalon Backend ==========
+	The FPGA, or the mock device, through the register functions of fpga.cpp.
+	A single Cell Array -- One lane.
+
+	clear() resets the cell outputs before every grid, grids with feedback loops depend on them.
+	replace() is only done once something else is used. When a grid is loaded right after it,
+	fpga_load_image() replaces the clear and the upload, and only writes the changed RAM words.
+*/
+
+class AvalonBackend : public Backend {
+
+private:
+
+	// Clear replaced by the next load, not yet done
+	bool pending;
+
+	void flush (void) {
+		if (pending) fpga_clear ();
+		pending = 0;
+	}
+
+public:
+
+	AvalonBackend (void) : pending (0) {}
+
+	const char *get_name (void) { return fpga_is_mock () ? "Mock" : "FPGA"; }
+
+	unsigned int get_lanes (void) { return 1; }
+
+	void clear (void) { fpga_clear (); pending = 0; }
+
+	void replace (void) { pending = 1; }
+
+	// Already in the RAM format -- Straight to the registers
+	void load_image (const unsigned int &lane, const uint32_t *const image) {
+		fpga_load_image (image);
+
+		// Sets input to zero, same as fpga_clear()
+		if (pending) fpga_set_input (0x0);
+		pending = 0;
+	}
+
+	// The FPGA always runs every cell
+	void set_cone (const uint64_t &mask) {}
+
+	void apply_input (const uint64_t &input) { flush (); fpga_set_input (input); }
+
+	void step (const uint16_t &cycles) { flush (); fpga_wind_clock (cycles); }
+
+	uint16_t settle (const uint16_t &limit) { flush (); return fpga_settle (limit); }
+
+	uint64_t read_output (const unsigned int &lane) { flush (); return fpga_get_output (); }
+
+	// No access to the register state -- See fpga_settle()
+	bool get_unstable (const unsigned int &lane) { return 0; }
+
+};
+
+
+
+/* ========== Backend Instances ==========
+	One software backend per thread -- sim.cpp evaluates the population with several worker threads.
+	The FPGA and the mock device are shared.
+*/
+
+static thread_local SoftBackend soft;
+static AvalonBackend avalon;
+
+
+
+/* ========== Backend Functions ========== */
+
+void Backend::evaluate_table (const uint32_t *const *const image, const unsigned int &count,
+unsigned int *const score, const bool *const settles) {
+	eval_table (*this, image, count, score, settles);
+}
+
+Backend *backend_get (void) {
+	if ( GlobalSettings::get_eval_backend () == BACKEND_SOFT ) return &soft;
+	return &avalon;
+}
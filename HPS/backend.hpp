@@ -0,0 +1,116 @@
+/* Header File for the Evaluation Backends
+	Repo: https://github.com/mimocha/ga-logic-circuit
+	Copyright (c) 2018 Chawit Leosrisook
+*/
+
+#ifndef BACKEND_HPP
+#define BACKEND_HPP
+
+/* Notes on the Evaluation Backends
+	A backend is whatever runs the circuits for the evaluation functions (eval.hpp).
+	It is selected at runtime, with the "EVAL Backend" setting:
+
+		BACKEND_SOFT -- Software model, the batched Cell Array (lca.hpp). LCA_BATCH lanes.
+		BACKEND_FPGA -- The FPGA, through the /dev/mem Avalon registers (fpga.hpp). ARM only.
+		BACKEND_MOCK -- The same Avalon registers, on the mock device (mock.hpp).
+
+	Every backend has one or more 'lanes', each lane runs its own grid.
+	Every lane gets the same input and the same clock, and has its own output.
+
+	The software backend is independent for every thread, see backend_get().
+	The FPGA and the mock device are shared, and should only be used by one thread.
+*/
+
+// Maximum number of lanes of any backend
+#define BACKEND_MAX_LANES LCA_BATCH
+
+class Backend {
+
+public:
+
+	virtual ~Backend (void) {}
+
+	/* ========== Properties ========== */
+
+	/* const char *get_name (void)
+		Returns the name of the backend, for printing.
+	*/
+	virtual const char *get_name (void) = 0;
+
+	/* unsigned int get_lanes (void)
+		Returns the number of lanes -- Grids which can be run together.
+	*/
+	virtual unsigned int get_lanes (void) = 0;
+
+
+	/* ========== Cell Array ========== */
+
+	/* void clear (void)
+		Clears every lane: RAM, cell outputs, and input. Same as fpga_clear().
+	*/
+	virtual void clear (void) = 0;
+
+	/* void replace (void)
+		Same as clear(), before loading grids which settle from any state, see eval_settles().
+		The FPGA / mock keep the cell outputs, and the next load_image() only writes
+		the RAM words which changed, see fpga_load_image().
+	*/
+	virtual void replace (void) = 0;
+
+	/* void load_image (const unsigned int &lane, const uint32_t *const image)
+		Writes a packed grid (global.hpp) to the RAM of 'lane'. Same as fpga_load_image().
+	*/
+	virtual void load_image (const unsigned int &lane, const uint32_t *const image) = 0;
+
+	/* void set_cone (const uint64_t &mask)
+		Only runs the cells which can influence the output bits in 'mask', if supported.
+		Lasts until the next clear(). See LogicCellArray::set_cone().
+	*/
+	virtual void set_cone (const uint64_t &mask) = 0;
+
+	/* void apply_input (const uint64_t &input)
+		Sets the Linux input of every lane. Same as fpga_set_input().
+	*/
+	virtual void apply_input (const uint64_t &input) = 0;
+
+	/* void step (const uint16_t &cycles)
+		Winds up the clock by 'cycles'. Same as fpga_wind_clock().
+	*/
+	virtual void step (const uint16_t &cycles) = 0;
+
+	/* uint16_t settle (const uint16_t &limit)
+		Runs until every lane settles, up to 'limit' clock cycles. Same as fpga_settle().
+		Returns the cycle length found, or 0 if unknown.
+	*/
+	virtual uint16_t settle (const uint16_t &limit) = 0;
+
+	/* uint64_t read_output (const unsigned int &lane)
+		Returns the output of 'lane'. Same as fpga_get_output().
+	*/
+	virtual uint64_t read_output (const unsigned int &lane) = 0;
+
+	/* bool get_unstable (const unsigned int &lane)
+		Returns 1 if 'lane' was still changing at the end of the last settle().
+	*/
+	virtual bool get_unstable (const unsigned int &lane) = 0;
+
+
+	/* ========== Evaluation ========== */
+
+	/* void evaluate_table (const uint32_t *const *const image, const unsigned int &count,
+		unsigned int *const score, const bool *const settles = NULL)
+
+		Scores 'count' packed grids against the current truth table, writes them to 'score'.
+		Runs as many grids together as there are lanes. See eval_table().
+	*/
+	virtual void evaluate_table (const uint32_t *const *const image, const unsigned int &count,
+	unsigned int *const score, const bool *const settles = NULL);
+
+};
+
+/* Backend *backend_get (void)
+	Returns the selected backend, for the calling thread.
+*/
+Backend *backend_get (void);
+
+#endif
@@ -7,8 +7,22 @@
 
 #include <stdio.h>		// printf, perror
 #include <stdint.h>		// uint definitions
+#include <string.h>		// memset, memcpy
 #include <iostream>		// cout
 
+// Table lookup row kernels -- See ca_gen_row_43()
+#if defined (__x86_64__) || defined (__i386__)
+	#define CA_SIMD_X86
+	#include <immintrin.h>	// SSSE3, AVX2 intrinsics
+#elif defined (__ARM_NEON) || defined (__ARM_NEON__)
+	#define CA_SIMD_NEON
+	#include <arm_neon.h>	// NEON intrinsics
+	#include <sys/auxv.h>	// getauxval
+	#ifndef HWCAP_NEON
+		#define HWCAP_NEON (1 << 12)
+	#endif
+#endif
+
 
 
 /* ========== Custom Header Include ========== */
@@ -27,10 +41,33 @@ static uint16_t color = 4;
 static uint16_t dimx = 64;
 static uint16_t dimy = 64;
 static uint16_t nb_count = 3;
+static uint32_t dna_length = 64;
 
 // Neighboring Cell Offset
 static int offset = 1;
 
+// Weight of the most significant neighbor, for each color: drop [c] == c * COLOR^(NB-1)
+static uint32_t drop [MAX_CA_COLOR];
+
+/* Row Kernel -- Selected by ca_init()
+	Specialized ca_gen_row<COLOR, NB>() for the (color, neighbor) pairs in use,
+	ca_gen_row_any() for every other pair. The default 4/3 pair uses a table lookup kernel,
+	ca_gen_row_43(), when the CPU has one.
+*/
+typedef void (*ca_kernel) (const uint8_t *const input, uint8_t *const output,
+	const uint8_t *const DNA, uint8_t *const trace, const uint8_t &row);
+
+template <unsigned int COLOR, unsigned int NB>
+static void ca_gen_row (const uint8_t *const input, uint8_t *const output,
+	const uint8_t *const DNA, uint8_t *const trace, const uint8_t &row);
+
+// Same (color, neighbor) pair as the defaults above
+static ca_kernel row_kernel = ca_gen_row<4, 3>;
+static const char *kernel_name = "Generic";
+
+// Set if ca_gen_batch() generates its circuits in lanes -- See ca_init()
+static bool batch_lanes = 0;
+
 // Initialization Flag
 static bool ca_init_flag = 0;
 
@@ -41,6 +78,8 @@ using namespace GlobalSettings;
 
 /* ========== Miscellaneous Functions ========== */
 
+static ca_kernel ca_select_kernel (const uint16_t &color, const uint16_t &nb_count);
+
 void ca_init (void) {
 	printf ("Initializing CA... ");
 
@@ -49,15 +88,31 @@ void ca_init (void) {
 	dimy = get_ca_dimy ();
 	color = get_ca_color ();
 	nb_count = get_ca_nb ();
+	dna_length = fast_pow (color, nb_count);
 
 	// Calculate index offset for neighboring cells. Only work with odd-numbers
 	offset = ((nb_count - 1) / 2);
 
+	// Sliding window table, see ca_gen_row()
+	const uint32_t weight = fast_pow (color, nb_count - 1);
+	for (uint16_t c = 0 ; c < MAX_CA_COLOR ; c++) {
+		drop [c] = c * weight;
+	}
+
+	// Row kernel for this (color, neighbor) pair
+	row_kernel = ca_select_kernel (color, nb_count);
+
+	// Lanes need AVX2 gathers, and a rule-usage mask of a single word
+	batch_lanes = 0;
+	#ifdef CA_SIMD_X86
+	batch_lanes = (dna_length <= CA_BATCH_DNA) && __builtin_cpu_supports ("avx2");
+	#endif
+
 	// Sets initialization flag to TRUE
 	ca_init_flag = 1;
 
 	// Prints Message and Returns
-	printf (ANSI_GREEN "DONE\n" ANSI_RESET);
+	printf (ANSI_GREEN "DONE" ANSI_RESET " | Row Kernel: %s\n", kernel_name);
 	return;
 }
 
@@ -78,46 +133,328 @@ void ca_need_update (void) {
 
 /* ========== Generation Functions ========== */
 
-uint8_t ca_func (const uint8_t *const input) {
-	// DNA index number
-	uint32_t idx = 0;
+/* static void ca_gen_row_any (const uint8_t *const input, uint8_t *const output,
+	const uint8_t *const DNA, uint8_t *const trace, const uint8_t &row)
 
-	// Calculates index number value
-	for (uint16_t c = 0; c < nb_count; c++) {
-		idx = idx + (input [c] * fast_pow (color, c));
+	Generic row kernel, any color and neighbor count -- Sliding window, see ca_gen_row() in ca.hpp.
+*/
+static void ca_gen_row_any (const uint8_t *const input, uint8_t *const output,
+const uint8_t *const DNA, uint8_t *const trace, const uint8_t &row) {
+	// Padded row -- pad [x + n] is neighbor 'n' of cell 'x', edges already looped
+	uint8_t pad [PHYSICAL_DIMX + MAX_CA_NB];
+	const uint16_t right = nb_count - 1 - offset;
+
+	for (uint16_t n = 0 ; n < offset ; n++) {
+		pad [n] = input [(dimx - offset + n) % dimx];
 	}
 
-	// Returns the index number
-	return idx;
+	for (uint16_t x = 0 ; x < dimx ; x++) {
+		pad [offset + x] = input [x];
+	}
+
+	for (uint16_t n = 0 ; n < right ; n++) {
+		pad [offset + dimx + n] = input [n % dimx];
+	}
+
+	// Index of the rightmost cell -- Most significant neighbor first
+	uint32_t dna_index = 0;
+	for (int n = nb_count - 1 ; n >= 0 ; n--) {
+		dna_index = dna_index * color + pad [dimx - 1 + n];
+	}
+
+	// Iterate over entire row, right to left
+	for (int x = dimx - 1 ; x >= 0 ; x--) {
+		// Use the index to access value from DNA string
+		output [x] = DNA [ dna_index ];
+
+		// Traces the rule to the first row using it
+		if (trace != NULL && trace [dna_index] > row) trace [dna_index] = row;
+
+		// Slides the window one cell left -- Guarded, pad [-1] does not exist
+		if (x > 0) dna_index = (dna_index - drop [ pad [x - 1 + nb_count] ]) * color + pad [x - 1];
+	}
 }
 
 
-void ca_gen_row
-(const uint8_t *const input, uint8_t *const output, const uint8_t *const DNA) {
-	// Iterate over entire row
-	for (uint16_t x = 0 ; x < dimx ; x++) {
-		// Declare Neighbor Array
-		uint8_t neighbor [nb_count];
+/* template <unsigned int COLOR, unsigned int NB> static void ca_gen_row (...)
+	Row kernel specialized for a (COLOR, NB) pair, same arguments and result as ca_gen_row_any().
+	Every cell's index is computed on its own, straight from the padded row --
+	The neighbor loop has a constant count and the multiply a constant factor, so both unroll,
+	and nothing is carried from one cell to the next: each loop over the row can be vectorized.
+*/
+template <unsigned int COLOR, unsigned int NB>
+static void ca_gen_row (const uint8_t *const input, uint8_t *const output,
+const uint8_t *const DNA, uint8_t *const trace, const uint8_t &row) {
+	const unsigned int OFFSET = (NB - 1) / 2;
+
+	// Local copy -- The byte stores below could alias the static, and reload it every cell
+	const uint16_t width = dimx;
+
+	// Padded row -- pad [x + n] is neighbor 'n' of cell 'x', edges already looped
+	uint8_t pad [PHYSICAL_DIMX + NB];
+	uint16_t index [PHYSICAL_DIMX];
+
+	for (unsigned int n = 0 ; n < OFFSET ; n++) {
+		pad [n] = input [(width - OFFSET + n) % width];
+	}
+
+	memcpy (pad + OFFSET, input, width);
 
-		for (uint16_t n = 0 ; n < nb_count ; n++) {
-			// Calculate the index location -- Can be negative
-			int16_t idx = x - offset + n;
+	for (unsigned int n = 0 ; n < NB - 1 - OFFSET ; n++) {
+		pad [OFFSET + width + n] = input [n % width];
+	}
 
-			// Index looping
-			// Guarantees index of range (0,DIMX]
-			// (INDEX + DIMX) % DIMX == LOOPED INDEX
-			idx = idx + dimx;
-			idx = idx % dimx;
+	// DNA index of every cell -- Most significant neighbor first
+	for (uint16_t x = 0 ; x < width ; x++) {
+		uint16_t dna_index = 0;
 
-			neighbor [n] = input [idx];
+		for (int n = NB - 1 ; n >= 0 ; n--) {
+			dna_index = dna_index * COLOR + pad [x + n];
 		}
 
-		// Call function ca_func() to generate a DNA index
-		const unsigned int dna_index = ca_func (neighbor);
+		index [x] = dna_index;
+	}
 
-		// Use the index to access value from DNA string
-		output [x] = DNA [ dna_index ];
+	for (uint16_t x = 0 ; x < width ; x++) {
+		output [x] = DNA [ index [x] ];
+	}
+
+	/* Traces every rule to the first row using it
+		Rows are generated in order, so a rule is only traced once -- A rarely taken branch is cheaper
+		than storing every cell, as cells sharing a rule would then wait on each other's store.
+	*/
+	if (trace != NULL) {
+		for (uint16_t x = 0 ; x < width ; x++) {
+			if (trace [ index [x] ] > row) trace [ index [x] ] = row;
+		}
+	}
+}
+
+/* Table Lookup Row Kernels -- 4 colors, 3 neighbors
+	The 64 rules of the DNA fit in the byte shuffle registers of the CPU: a single table lookup
+	instruction maps a whole vector of cell indices to their rules, 16 or 32 cells at once.
+
+		index = left + 4 * center + 16 * right	-- Same as ca_gen_row<4, 3>()
+
+	Indices are built from three loads of the padded row, offset by one cell each.
+	Cells are 0 to 3, so the shifts never carry into the next byte, even 16 bits at a time.
+	The padded row is always PHYSICAL_DIMX cells wide, zero past the looped edge:
+	cells past 'dimx' are computed from it, then cleared, same as the scalar kernels leave them.
+
+	x86 (SSSE3, AVX2) -- pshufb only looks up 16 bytes: the DNA is split into 4 tables,
+		every table is looked up with the low 4 bits, and the high 2 bits select the result.
+	ARMv7 (NEON) -- vtbl4 looks up 32 bytes: the first half is looked up with the index,
+		vtbx4 then fills in the indices of the second half, out of range for the first.
+
+	Selected at run time by ca_select_kernel(), from the features of the CPU.
+	Rule tracing stays scalar, on the indices kept by the vector loop.
+*/
+
+/* static void ca_pad_row_43 (const uint8_t *const input, uint8_t *const pad)
+	Padded row of the table lookup kernels -- pad [x + n] is neighbor 'n' of cell 'x'.
+	'pad' holds PHYSICAL_DIMX + 32 cells, every cell past the looped edge is 0.
+*/
+static void ca_pad_row_43 (const uint8_t *const input, uint8_t *const pad) {
+	const uint16_t width = dimx;
+
+	memset (pad, 0, PHYSICAL_DIMX + 32);
+	pad [0] = input [width - 1];
+	memcpy (pad + 1, input, width);
+	pad [width + 1] = input [0];
+}
+
+/* static void ca_trace_row_43 (const uint8_t *const index, uint8_t *const trace, const uint8_t &row)
+	Traces the rule of every cell to the first row using it, same as ca_gen_row<4, 3>().
+*/
+static void ca_trace_row_43 (const uint8_t *const index, uint8_t *const trace, const uint8_t &row) {
+	const uint16_t width = dimx;
+
+	for (uint16_t x = 0 ; x < width ; x++) {
+		if (trace [ index [x] ] > row) trace [ index [x] ] = row;
+	}
+}
+
+#ifdef CA_SIMD_X86
+
+/* static void ca_gen_row_43_ssse3 (...)
+	Table lookup kernel, 16 cells at a time -- SSSE3 pshufb.
+*/
+__attribute__ ((target ("ssse3")))
+static void ca_gen_row_43_ssse3 (const uint8_t *const input, uint8_t *const output,
+const uint8_t *const DNA, uint8_t *const trace, const uint8_t &row) {
+	uint8_t pad [PHYSICAL_DIMX + 32];
+	uint8_t index [PHYSICAL_DIMX];
+	ca_pad_row_43 (input, pad);
+
+	const __m128i low = _mm_set1_epi8 (0x0F);
+	__m128i table [4], select [4];
+	for (int t = 0 ; t < 4 ; t++) {
+		table [t] = _mm_loadu_si128 ((const __m128i *) (DNA + 16 * t));
+		select [t] = _mm_set1_epi8 (t);
+	}
+
+	for (uint16_t x = 0 ; x < PHYSICAL_DIMX ; x += 16) {
+		const __m128i left = _mm_loadu_si128 ((const __m128i *) (pad + x));
+		const __m128i center = _mm_loadu_si128 ((const __m128i *) (pad + x + 1));
+		const __m128i right = _mm_loadu_si128 ((const __m128i *) (pad + x + 2));
+
+		const __m128i idx = _mm_or_si128 (left,
+			_mm_or_si128 (_mm_slli_epi16 (center, 2), _mm_slli_epi16 (right, 4)));
+		const __m128i lo = _mm_and_si128 (idx, low);
+		const __m128i hi = _mm_and_si128 (_mm_srli_epi16 (idx, 4), low);
+
+		__m128i rule = _mm_setzero_si128 ();
+		for (int t = 0 ; t < 4 ; t++) {
+			rule = _mm_or_si128 (rule, _mm_and_si128 (_mm_cmpeq_epi8 (hi, select [t]),
+				_mm_shuffle_epi8 (table [t], lo)));
+		}
+
+		_mm_storeu_si128 ((__m128i *) (output + x), rule);
+		_mm_storeu_si128 ((__m128i *) (index + x), idx);
+	}
+
+	memset (output + dimx, 0, PHYSICAL_DIMX - dimx);
+	if (trace != NULL) ca_trace_row_43 (index, trace, row);
+}
+
+/* static void ca_gen_row_43_avx2 (...)
+	Table lookup kernel, 32 cells at a time -- AVX2 vpshufb, each table repeated in both 128-bit lanes.
+*/
+__attribute__ ((target ("avx2")))
+static void ca_gen_row_43_avx2 (const uint8_t *const input, uint8_t *const output,
+const uint8_t *const DNA, uint8_t *const trace, const uint8_t &row) {
+	uint8_t pad [PHYSICAL_DIMX + 32];
+	uint8_t index [PHYSICAL_DIMX];
+	ca_pad_row_43 (input, pad);
+
+	const __m256i low = _mm256_set1_epi8 (0x0F);
+	__m256i table [4], select [4];
+	for (int t = 0 ; t < 4 ; t++) {
+		table [t] = _mm256_broadcastsi128_si256 (_mm_loadu_si128 ((const __m128i *) (DNA + 16 * t)));
+		select [t] = _mm256_set1_epi8 (t);
+	}
+
+	for (uint16_t x = 0 ; x < PHYSICAL_DIMX ; x += 32) {
+		const __m256i left = _mm256_loadu_si256 ((const __m256i *) (pad + x));
+		const __m256i center = _mm256_loadu_si256 ((const __m256i *) (pad + x + 1));
+		const __m256i right = _mm256_loadu_si256 ((const __m256i *) (pad + x + 2));
+
+		const __m256i idx = _mm256_or_si256 (left,
+			_mm256_or_si256 (_mm256_slli_epi16 (center, 2), _mm256_slli_epi16 (right, 4)));
+		const __m256i lo = _mm256_and_si256 (idx, low);
+		const __m256i hi = _mm256_and_si256 (_mm256_srli_epi16 (idx, 4), low);
+
+		__m256i rule = _mm256_setzero_si256 ();
+		for (int t = 0 ; t < 4 ; t++) {
+			rule = _mm256_or_si256 (rule, _mm256_and_si256 (_mm256_cmpeq_epi8 (hi, select [t]),
+				_mm256_shuffle_epi8 (table [t], lo)));
+		}
+
+		_mm256_storeu_si256 ((__m256i *) (output + x), rule);
+		_mm256_storeu_si256 ((__m256i *) (index + x), idx);
+	}
+
+	memset (output + dimx, 0, PHYSICAL_DIMX - dimx);
+	if (trace != NULL) ca_trace_row_43 (index, trace, row);
+}
+
+#endif
+
+#ifdef CA_SIMD_NEON
+
+/* static void ca_gen_row_43_neon (...)
+	Table lookup kernel, 8 cells at a time -- ARMv7 NEON vtbl4 / vtbx4.
+*/
+static void ca_gen_row_43_neon (const uint8_t *const input, uint8_t *const output,
+const uint8_t *const DNA, uint8_t *const trace, const uint8_t &row) {
+	uint8_t pad [PHYSICAL_DIMX + 32];
+	uint8_t index [PHYSICAL_DIMX];
+	ca_pad_row_43 (input, pad);
+
+	uint8x8x4_t first, second;
+	for (int t = 0 ; t < 4 ; t++) {
+		first.val [t] = vld1_u8 (DNA + 8 * t);
+		second.val [t] = vld1_u8 (DNA + 32 + 8 * t);
+	}
+
+	const uint8x8_t half = vdup_n_u8 (32);
+
+	for (uint16_t x = 0 ; x < PHYSICAL_DIMX ; x += 8) {
+		const uint8x8_t left = vld1_u8 (pad + x);
+		const uint8x8_t center = vld1_u8 (pad + x + 1);
+		const uint8x8_t right = vld1_u8 (pad + x + 2);
+
+		const uint8x8_t idx = vorr_u8 (left, vorr_u8 (vshl_n_u8 (center, 2), vshl_n_u8 (right, 4)));
+
+		// Indices below 32 wrap around to 224 and up, left untouched by vtbx4
+		uint8x8_t rule = vtbl4_u8 (first, idx);
+		rule = vtbx4_u8 (rule, second, vsub_u8 (idx, half));
+
+		vst1_u8 (output + x, rule);
+		vst1_u8 (index + x, idx);
+	}
+
+	memset (output + dimx, 0, PHYSICAL_DIMX - dimx);
+	if (trace != NULL) ca_trace_row_43 (index, trace, row);
+}
+
+#endif
+
+/* static ca_kernel ca_gen_row_43 (void)
+	Returns the fastest 4/3 row kernel the CPU runs, and sets its name, see kernel_name.
+*/
+static ca_kernel ca_gen_row_43 (void) {
+	#ifdef CA_SIMD_X86
+	__builtin_cpu_init ();
+
+	if (__builtin_cpu_supports ("avx2")) {
+		kernel_name = "AVX2";
+		return ca_gen_row_43_avx2;
+	}
+
+	if (__builtin_cpu_supports ("ssse3")) {
+		kernel_name = "SSSE3";
+		return ca_gen_row_43_ssse3;
+	}
+	#endif
+
+	#ifdef CA_SIMD_NEON
+	if (getauxval (AT_HWCAP) & HWCAP_NEON) {
+		kernel_name = "NEON";
+		return ca_gen_row_43_neon;
 	}
+	#endif
+
+	kernel_name = "Specialized";
+	return ca_gen_row<4, 3>;
+}
+
+/* static ca_kernel ca_select_kernel (const uint16_t &color, const uint16_t &nb_count)
+	Returns the row kernel for a (color, neighbor) pair, and sets its name, see kernel_name.
+*/
+static ca_kernel ca_select_kernel (const uint16_t &color, const uint16_t &nb_count) {
+	kernel_name = "Specialized";
+
+	switch ((color << 8) | nb_count) {
+		case (4 << 8) | 3: return ca_gen_row_43 ();
+		case (2 << 8) | 3: return ca_gen_row<2, 3>;
+		case (4 << 8) | 5: return ca_gen_row<4, 5>;
+		case (2 << 8) | 5: return ca_gen_row<2, 5>;
+		case (3 << 8) | 3: return ca_gen_row<3, 3>;
+		default:
+			kernel_name = "Generic";
+			return ca_gen_row_any;
+	}
+}
+
+/* static void ca_gen_row (const uint8_t *const input, uint8_t *const output,
+	const uint8_t *const DNA, uint8_t *const trace = NULL, const uint8_t &row = 0)
+
+	Runs the row kernel selected by ca_init(), see row_kernel.
+*/
+static void ca_gen_row (const uint8_t *const input, uint8_t *const output,
+const uint8_t *const DNA, uint8_t *const trace = NULL, const uint8_t &row = 0) {
+	row_kernel (input, output, DNA, trace, row);
 }
 
 
@@ -138,6 +475,349 @@ void ca_gen_grid
 
 
 
+/* ========== Packed Grid Functions ========== */
+
+/* static void ca_pack_row (const uint8_t *const row, uint32_t *const word)
+	Packs one row of PHYSICAL_DIMX cells into PACKED_ROW words.
+*/
+static void ca_pack_row (const uint8_t *const row, uint32_t *const word) {
+	for (uint16_t w = 0 ; w < PACKED_ROW ; w++) {
+		uint32_t data = 0;
+
+		// Highest cell first, the lowest cell of the word ends up in the lowest nibble
+		for (int k = PACKED_CELL - 1 ; k >= 0 ; k--) {
+			data = (data << 4) | (row [w * PACKED_CELL + k] & 0xF);
+		}
+
+		word [w] = data;
+	}
+}
+
+/* static void ca_unpack_row (const uint32_t *const word, uint8_t *const row)
+	Reverse of ca_pack_row().
+*/
+static void ca_unpack_row (const uint32_t *const word, uint8_t *const row) {
+	for (uint16_t x = 0 ; x < PHYSICAL_DIMX ; x++) {
+		row [x] = (word [x / PACKED_CELL] >> (4 * (x % PACKED_CELL))) & 0xF;
+	}
+}
+
+/* static void ca_gen_from (const ca_image &out, const uint8_t *const DNA,
+	const uint8_t *const input, const uint16_t &start)
+
+	Generates the rows [start, 2*DIMY) of both passes, 'input' being the row before 'start'.
+	Only two rows are kept at a time -- Each is packed into 'out' as it is generated.
+*/
+static void ca_gen_from (const ca_image &out, const uint8_t *const DNA,
+const uint8_t *const input, const uint16_t &start) {
+	// Alternating rows -- Cells past DIMX stay empty
+	uint8_t buffer [2][PHYSICAL_DIMX] = {{0}};
+	const uint8_t *prev = input;
+
+	for (uint16_t r = start ; r < 2 * dimy ; r++) {
+		uint8_t *const row = buffer [r & 1];
+		ca_gen_row (prev, row, DNA, out.trace, r);
+		prev = row;
+
+		if (r >= dimy) {
+			ca_pack_row (row, &out.image [(r - dimy) * PACKED_ROW]);
+		} else if (out.first != NULL) {
+			ca_pack_row (row, &out.first [r * PACKED_ROW]);
+		}
+	}
+}
+
+/* static void ca_trace_usage (const uint8_t *const trace, uint64_t *const usage)
+	Sets the rule-usage bitmap from the rule-index trace.
+*/
+static void ca_trace_usage (const uint8_t *const trace, uint64_t *const usage) {
+	memset (usage, 0, CA_USAGE_WORDS (dna_length) * sizeof (uint64_t));
+
+	for (uint32_t i = 0 ; i < dna_length ; i++) {
+		if (trace [i] != CA_UNUSED) usage [i / 64] |= (uint64_t) 1 << (i % 64);
+	}
+}
+
+void ca_gen_image (const ca_image &out, const uint8_t *const DNA, const uint8_t *const seed) {
+	const uint8_t empty [PHYSICAL_DIMX] = {0};
+
+	if (out.trace != NULL) memset (out.trace, CA_UNUSED, dna_length);
+
+	// First pass from the seed, second pass from the bottom row of the first
+	ca_gen_from (out, DNA, (seed != NULL) ? seed : empty, 0);
+
+	// Rows past DIMY are empty
+	for (uint32_t i = dimy * PACKED_ROW ; i < PACKED_SIZE ; i++) {
+		out.image [i] = 0;
+		if (out.first != NULL) out.first [i] = 0;
+	}
+
+	if (out.usage != NULL) ca_trace_usage (out.trace, out.usage);
+}
+
+void ca_regen_image (const ca_image &out, const ca_image &parent,
+const uint8_t *const DNA, const uint8_t *const seed,
+const uint32_t *const changed, const uint32_t &count) {
+	// First row looking up a changed gene
+	uint16_t start = CA_UNUSED;
+
+	for (uint32_t k = 0 ; k < count ; k++) {
+		if (parent.trace [changed [k]] < start) start = parent.trace [changed [k]];
+	}
+
+	// Every row before it is the parent's
+	memcpy (out.image, parent.image, PACKED_SIZE * sizeof (uint32_t));
+	memcpy (out.first, parent.first, PACKED_SIZE * sizeof (uint32_t));
+	memcpy (out.trace, parent.trace, dna_length);
+	memcpy (out.usage, parent.usage, CA_USAGE_WORDS (dna_length) * sizeof (uint64_t));
+
+	if (start == CA_UNUSED) return;
+
+	// Genes first used from there on are traced again
+	for (uint32_t i = 0 ; i < dna_length ; i++) {
+		if (out.trace [i] >= start) out.trace [i] = CA_UNUSED;
+	}
+
+	// Row before 'start' -- The seed, the first pass, or the circuit itself
+	uint8_t input [PHYSICAL_DIMX] = {0};
+
+	if (start == 0) {
+		if (seed != NULL) memcpy (input, seed, dimx);
+	} else if (start <= dimy) {
+		ca_unpack_row (&parent.first [(start - 1) * PACKED_ROW], input);
+	} else {
+		ca_unpack_row (&parent.image [(start - dimy - 1) * PACKED_ROW], input);
+	}
+
+	ca_gen_from (out, DNA, input, start);
+	ca_trace_usage (out.trace, out.usage);
+}
+
+#ifdef CA_SIMD_X86
+
+/* static void ca_gen_lanes_avx2 (const ca_image *const out, const uint8_t *const *const DNA,
+	const unsigned int &lanes, const uint8_t *const seed)
+
+	ca_gen_batch() of up to CA_BATCH circuits, one per lane -- AVX2, DNA of up to 64 genes.
+	See ca_gen_batch() in ca.hpp.
+
+	Rules are looked up 8 lanes at a time, with a gather from the transposed DNA.
+	Every lane marks the rules it used in a 64-bit mask, 4 lanes at a time, and
+	only the rules first used in a row are traced, once the row is done.
+*/
+#if (CA_BATCH != 32)
+	#error "ca_gen_lanes_avx2() requires CA_BATCH == 32 -- Gather addresses and byte packing"
+#endif
+
+__attribute__ ((target ("avx2")))
+static void ca_gen_lanes_avx2 (const ca_image *const out, const uint8_t *const *const DNA,
+const unsigned int &lanes, const uint8_t *const seed) {
+	const unsigned int B = CA_BATCH;
+
+	// Local copies -- The byte stores below could alias the statics, and reload them every cell
+	const uint16_t width = dimx;
+	const uint16_t height = dimy;
+	const uint16_t colors = color;
+	const uint32_t genes = dna_length;
+	const int nb = nb_count;
+	const int left = offset;
+
+	// Transposed DNA -- table [i * B + k] is gene 'i' of lane 'k'. Gathers read 3 bytes past the last
+	uint8_t table [64 * CA_BATCH + 4] = {0};
+
+	for (unsigned int k = 0 ; k < lanes ; k++) {
+		for (uint32_t i = 0 ; i < genes ; i++) {
+			table [i * B + k] = DNA [k][i];
+		}
+	}
+
+	// Rules used by each lane -- In the current row, and in any row so far
+	uint64_t used [CA_BATCH];
+	uint64_t seen [CA_BATCH] = {0};
+	uint8_t trace [CA_BATCH][64];
+	memset (trace, CA_UNUSED, sizeof (trace));
+
+	/* Rows in SoA layout -- Cell 'x' of lane 'k' is soa [(left + x) * B + k]
+		Columns [0, left) and [left + DIMX, DIMX + nb - 1) loop the edges around.
+	*/
+	uint8_t soa [2][(PHYSICAL_DIMX + MAX_CA_NB) * CA_BATCH];
+	uint32_t word [PACKED_ROW][CA_BATCH];
+	memset (soa, 0, sizeof (soa));
+
+	const __m256i factor = _mm256_set1_epi32 (colors);
+	const __m256i low = _mm256_set1_epi32 (0xFF);
+	const __m256i one = _mm256_set1_epi64x (1);
+	const __m256i order = _mm256_setr_epi32 (0, 4, 1, 5, 2, 6, 3, 7);
+
+	for (uint16_t r = 0 ; r < 2 * height ; r++) {
+		uint8_t *const prev = soa [(r + 1) & 1];
+		uint8_t *const next = soa [r & 1];
+
+		if (r == 0) {
+			// Same indices in every lane, from the shared seed -- Only the lookup differs
+			const uint8_t empty [PHYSICAL_DIMX] = {0};
+			const uint8_t *const input = (seed != NULL) ? seed : empty;
+			uint64_t row_used = 0;
+
+			for (uint16_t x = 0 ; x < width ; x++) {
+				uint32_t dna_index = 0;
+
+				for (int n = nb - 1 ; n >= 0 ; n--) {
+					dna_index = dna_index * colors + input [(x + n + width - left) % width];
+				}
+
+				memcpy (&next [(left + x) * B], &table [dna_index * B], B);
+				row_used |= (uint64_t) 1 << dna_index;
+			}
+
+			for (unsigned int k = 0 ; k < B ; k++) {
+				used [k] = row_used;
+			}
+		} else {
+			for (int n = 0 ; n < left ; n++) {
+				memcpy (&prev [n * B], &prev [(width + n) * B], B);
+			}
+
+			for (int n = 0 ; n < nb - 1 - left ; n++) {
+				memcpy (&prev [(left + width + n) * B], &prev [(left + n) * B], B);
+			}
+
+			__m256i mask [CA_BATCH / 4];
+			for (unsigned int m = 0 ; m < B / 4 ; m++) {
+				mask [m] = _mm256_setzero_si256 ();
+			}
+
+			// One cell at a time, every lane together
+			for (uint16_t x = 0 ; x < width ; x++) {
+				__m256i rule [CA_BATCH / 8];
+
+				for (unsigned int g = 0 ; g < B / 8 ; g++) {
+					// Most significant neighbor first
+					const uint8_t *cell = &prev [(x + nb - 1) * B + 8 * g];
+					__m256i idx = _mm256_cvtepu8_epi32 (_mm_loadl_epi64 ((const __m128i *) cell));
+
+					for (int n = nb - 2 ; n >= 0 ; n--) {
+						cell = &prev [(x + n) * B + 8 * g];
+						idx = _mm256_add_epi32 (_mm256_mullo_epi32 (idx, factor),
+							_mm256_cvtepu8_epi32 (_mm_loadl_epi64 ((const __m128i *) cell)));
+					}
+
+					// table [idx * B + k], lanes k = 8g to 8g + 7 -- (idx << 5) is (idx * B)
+					const __m256i lane = _mm256_setr_epi32 (0, 1, 2, 3, 4, 5, 6, 7);
+					const __m256i addr = _mm256_add_epi32 (_mm256_slli_epi32 (idx, 5),
+						_mm256_add_epi32 (lane, _mm256_set1_epi32 (8 * g)));
+					rule [g] = _mm256_and_si256 (_mm256_i32gather_epi32 ((const int *) table, addr, 1), low);
+
+					mask [2 * g] = _mm256_or_si256 (mask [2 * g], _mm256_sllv_epi64 (one,
+						_mm256_cvtepu32_epi64 (_mm256_castsi256_si128 (idx))));
+					mask [2 * g + 1] = _mm256_or_si256 (mask [2 * g + 1], _mm256_sllv_epi64 (one,
+						_mm256_cvtepu32_epi64 (_mm256_extracti128_si256 (idx, 1))));
+				}
+
+				// 32-bit lanes back to bytes -- The packs interleave the 128-bit halves, 'order' undoes it
+				const __m256i lo = _mm256_packus_epi32 (rule [0], rule [1]);
+				const __m256i hi = _mm256_packus_epi32 (rule [2], rule [3]);
+				const __m256i bytes = _mm256_permutevar8x32_epi32 (_mm256_packus_epi16 (lo, hi), order);
+				_mm256_storeu_si256 ((__m256i *) &next [(left + x) * B], bytes);
+			}
+
+			for (unsigned int m = 0 ; m < B / 4 ; m++) {
+				_mm256_storeu_si256 ((__m256i *) &used [4 * m], mask [m]);
+			}
+		}
+
+		// Traces the rules used for the first time
+		for (unsigned int k = 0 ; k < lanes ; k++) {
+			uint64_t fresh = used [k] & ~seen [k];
+			seen [k] |= used [k];
+
+			while (fresh) {
+				trace [k][ __builtin_ctzll (fresh) ] = r;
+				fresh &= fresh - 1;
+			}
+		}
+
+		// Packs the row of every lane together -- Cells past DIMX stay empty
+		for (uint16_t w = 0 ; w < PACKED_ROW ; w++) {
+			for (unsigned int k = 0 ; k < B ; k++) {
+				word [w][k] = 0;
+			}
+
+			for (uint16_t c = 0 ; c < PACKED_CELL && w * PACKED_CELL + c < width ; c++) {
+				const uint8_t *const cell = &next [(left + w * PACKED_CELL + c) * B];
+
+				for (unsigned int k = 0 ; k < B ; k++) {
+					word [w][k] |= (uint32_t) (cell [k] & 0xF) << (4 * c);
+				}
+			}
+		}
+
+		for (unsigned int k = 0 ; k < lanes ; k++) {
+			uint32_t *dest;
+
+			if (r >= height) {
+				dest = &out [k].image [(r - height) * PACKED_ROW];
+			} else if (out [k].first != NULL) {
+				dest = &out [k].first [r * PACKED_ROW];
+			} else {
+				continue;
+			}
+
+			for (uint16_t w = 0 ; w < PACKED_ROW ; w++) {
+				dest [w] = word [w][k];
+			}
+		}
+	}
+
+	for (unsigned int k = 0 ; k < lanes ; k++) {
+		// Rows past DIMY are empty
+		for (uint32_t i = height * PACKED_ROW ; i < PACKED_SIZE ; i++) {
+			out [k].image [i] = 0;
+			if (out [k].first != NULL) out [k].first [i] = 0;
+		}
+
+		if (out [k].trace == NULL) continue;
+
+		memcpy (out [k].trace, trace [k], genes);
+		if (out [k].usage != NULL) ca_trace_usage (out [k].trace, out [k].usage);
+	}
+}
+
+#endif
+
+void ca_gen_batch (const ca_image *const out, const uint8_t *const *const DNA,
+const unsigned int &count, const uint8_t *const seed) {
+	for (unsigned int base = 0 ; base < count ; base += CA_BATCH) {
+		const unsigned int lanes = (count - base < CA_BATCH) ? (count - base) : CA_BATCH;
+
+		#ifdef CA_SIMD_X86
+		// Mostly empty lanes cost more than the circuits generated one at a time
+		if (batch_lanes && 2 * lanes >= CA_BATCH) {
+			ca_gen_lanes_avx2 (out + base, DNA + base, lanes, seed);
+			continue;
+		}
+		#endif
+
+		for (unsigned int k = base ; k < base + lanes ; k++) {
+			ca_gen_image (out [k], DNA [k], seed);
+		}
+	}
+}
+
+void ca_pack_grid (const uint8_t *const *const grid, uint32_t *const image) {
+	for (uint16_t y = 0 ; y < PHYSICAL_DIMY ; y++) {
+		ca_pack_row (grid [y], &image [y * PACKED_ROW]);
+	}
+}
+
+void ca_unpack_image (const uint32_t *const image, uint8_t *const *const grid) {
+	for (uint16_t y = 0 ; y < PHYSICAL_DIMY ; y++) {
+		ca_unpack_row (&image [y * PACKED_ROW], grid [y]);
+	}
+}
+
+
+
 /* ========== Printing Functions ========== */
 
 void ca_print (const uint8_t &cell) {
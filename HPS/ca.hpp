@@ -36,26 +36,65 @@ void ca_need_update (void);
 
 /* ========== Generation Functions ========== */
 
-/* static uint8_t ca_func (const uint8_t *const neighbor)
-	Takes in a given neighboring cell array, and converts it into an index number.
-	The neighbor array is handled as a string of numbers, of base 'Color Count'.
-	The number string is provided to this function in LSB format.
-		ie, neighbor[0] < neighbor[1] < neighbor[2] ...
-	This algorithm can handle any arbitrary number of Neighbor and Color. (Theoretically)
-	The decimal value of this number string is calculated and returned as uint32_t.
-		uint32_t holds up to 2^32 or ~4.29 billion. -> DNA length of ~4.29 bil.
+// Words of a rule-usage bitmap, one bit per DNA index -- See ca_gen_image()
+#define CA_USAGE_WORDS(dna_length) (((dna_length) + 63) / 64)
 
-	Input is a const pointer to const uint8_t.
-	The values of the array, and the pointer does not change within this function.
+// Rule-index trace of a gene never looked up -- See ca_image
+#define CA_UNUSED 0xFF
+
+// Lanes of ca_gen_batch() -- Circuits generated together, each row is a vector over them
+#define CA_BATCH 32
+
+// Longest DNA generated in lanes by ca_gen_batch() -- Each lane marks its rules in a 64-bit mask
+#define CA_BATCH_DNA 64
+
+/* Generated Circuit
+	Everything ca_gen_image() keeps of a circuit, so ca_regen_image() can regenerate it incrementally.
+	Rows are numbered over both passes: rows [0, DIMY) are the first pass, [DIMY, 2*DIMY) the second.
+
+	image -- The circuit, the second pass. Packed grid format (global.hpp), PACKED_SIZE words
+	first -- The first pass, same format. May be NULL
+	trace -- Rule-index trace, one byte per DNA index: the first row which looked up that gene,
+	         CA_UNUSED if none did. May be NULL, unless 'usage' is given
+	usage -- Rule-usage bitmap, CA_USAGE_WORDS words: bit 'i' of word 'i / 64' is set
+	         if DNA [i] was looked up, in either pass. May be NULL
+
+	Genes which were never looked up do not affect the circuit --
+	Any DNA with the same genes at every used index, grows the exact same circuit from the same seed.
+	A generated circuit always uses at least one gene, the bitmap is never empty.
 */
+struct ca_image {
+	uint32_t *image;
+	uint32_t *first;
+	uint8_t *trace;
+	uint64_t *usage;
+};
 
-/* static void ca_gen_row
-	(const uint8_t *const input, uint8_t *const output, const uint8_t *const DNA)
+/* static void ca_gen_row (const uint8_t *const input, uint8_t *const output,
+	const uint8_t *const DNA, uint8_t *const trace = NULL, const uint8_t &row = 0)
 
 	Generates a 1-Dimensional CA array, given a DNA string.
 	Works cell-by-cell, generating the output array, using the input array cells.
 	Left-Right Edges loop.
 
+	The DNA index of a cell is its neighbors, read as a number of base 'Color Count',
+	the leftmost neighbor being the least significant digit:
+		index = neighbor[0] + neighbor[1] * COLOR + neighbor[2] * COLOR^2 ...
+
+	Sliding window -- The index is only computed in full for the rightmost cell.
+	Moving one cell left drops the most significant neighbor, looked up in a table of its weight,
+	multiplies by COLOR, and adds the new least significant neighbor. No powers, no loop per cell.
+	The input row is copied into a padded row first, so the neighbors of the edge cells never wrap.
+
+	Row kernels -- The sliding window is the generic kernel, for any (color, neighbor) pair.
+	The pairs in use, (4,3) (2,3) (4,5) (2,5) (3,3), have their own kernel instead,
+	ca_gen_row<COLOR, NB>(), with the color and neighbor count known at compile time.
+	The default (4,3) pair looks its 64 rules up with the byte shuffle of the CPU instead,
+	SSSE3 / AVX2 pshufb on the PC, NEON vtbl on the HPS, if the CPU running it has them.
+	ca_init() selects the kernel once, every row is generated through it.
+
+	If 'trace' is given, every DNA index looked up is traced to 'row', unless traced to an earlier row.
+
 	Inputs:
 	input is a const pointer to a const uint8_t. Neither the pointer nor the value will change.
 	output is a const pointer. The values of the array will change, but the pointer wont.
@@ -81,6 +120,58 @@ void ca_need_update (void);
 void ca_gen_grid
 (uint8_t *const *const grid, const uint8_t *const DNA, const uint8_t *const seed = NULL);
 
+/* void ca_gen_image (const ca_image &out, const uint8_t *const DNA, const uint8_t *const seed)
+	Generates a circuit straight into the packed grid format (global.hpp), into 'out.image'.
+	Same circuit as ca_gen_grid() with the seed, then once more without it.
+	The first pass only seeds the second, so only two rows are kept, never a full grid.
+	Cells outside of (DIMX, DIMY) are left empty. An empty row is used if 'seed' is NULL.
+
+	The first pass, trace, and usage bitmap are also written, if given. See ca_image.
+*/
+void ca_gen_image (const ca_image &out, const uint8_t *const DNA, const uint8_t *const seed);
+
+/* void ca_regen_image (const ca_image &out, const ca_image &parent,
+	const uint8_t *const DNA, const uint8_t *const seed,
+	const uint32_t *const changed, const uint32_t &count)
+
+	Incremental ca_gen_image(), for a DNA which differs from the parent's only at the 'count'
+	DNA indices listed in 'changed'. Every field of 'out' and 'parent' is required.
+
+	The parent's trace gives the first row which looked up a changed gene --
+	Every row before it is the parent's, and is copied. Only the rows from there on are generated.
+	Same result as ca_gen_image(), as long as 'parent' was generated with the same seed.
+*/
+void ca_regen_image (const ca_image &out, const ca_image &parent,
+	const uint8_t *const DNA, const uint8_t *const seed,
+	const uint32_t *const changed, const uint32_t &count);
+
+/* void ca_gen_batch (const ca_image *const out, const uint8_t *const *const DNA,
+	const unsigned int &count, const uint8_t *const seed)
+
+	ca_gen_image() of 'count' circuits, 'DNA [k]' into 'out [k]', all from the same seed.
+	Same result as 'count' calls to ca_gen_image().
+
+	Up to CA_BATCH circuits are generated together, row by row in lockstep, in SoA layout:
+	cell 'x' of every circuit sits side by side, one circuit per SIMD lane. The neighbor index,
+	the rule lookup (a gather from the transposed DNA), and the rule trace are vectors over the lanes.
+	The indices of the first row only depend on the seed, and are computed once for every lane.
+
+	Lanes need AVX2, and a DNA of up to CA_BATCH_DNA genes. Otherwise, or for a batch of less
+	than CA_BATCH / 2 circuits, the circuits are generated one at a time, through the row kernel.
+*/
+void ca_gen_batch (const ca_image *const out, const uint8_t *const *const DNA,
+	const unsigned int &count, const uint8_t *const seed);
+
+/* void ca_pack_grid (const uint8_t *const *const grid, uint32_t *const image)
+	Packs a (PHYSICAL_DIMY x PHYSICAL_DIMX) grid into the packed grid format (global.hpp).
+*/
+void ca_pack_grid (const uint8_t *const *const grid, uint32_t *const image);
+
+/* void ca_unpack_image (const uint32_t *const image, uint8_t *const *const grid)
+	Reverse of ca_pack_grid().
+*/
+void ca_unpack_image (const uint32_t *const image, uint8_t *const *const grid);
+
 
 
 /* ========== Printing Functions ========== */
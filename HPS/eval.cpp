@@ -14,9 +14,11 @@
 
 #include "eval.hpp"
 #include "ansi.hpp"
+#include "backend.hpp"
 #include "fast.hpp"
-#include "fpga.hpp"
 #include "global.hpp"
+#include "lca.hpp"
+#include "net.hpp"
 #include "truth.hpp"
 
 
@@ -34,6 +36,7 @@
 #define MAX_ES (PHYSICAL_DIMX*PHYSICAL_DIMY)
 
 // How many clock cycles to wait between each input / output pair
+// MAX_WAIT -- Limit for the settle evaluation mode, see eval_wait()
 #define MAX_WAIT 1024
 #define MIN_WAIT 256
 #define RAND_WAIT 256
@@ -43,6 +46,42 @@
 
 namespace tt = TruthTable;
 
+// Netlist -- Used by eval_settles() and eval_net(), one per thread, see backend.hpp
+static thread_local NetList net;
+
+
+/* ========== Helper Functions ========== */
+
+/* static uint16_t eval_wait (Backend &dev)
+	Runs every lane of 'dev' after a new input, before reading its output.
+
+	Default: Random wind-up clock count, (MIN_WAIT) to (MIN_WAIT + RAND_WAIT).
+	Settle evaluation mode: Runs until a fixed point or a limit cycle is found, up to MAX_WAIT.
+
+	Returns the cycle length found by the settle mode, see Backend::settle(). 0 otherwise.
+*/
+static uint16_t eval_wait (Backend &dev) {
+	if ( GlobalSettings::get_eval_settle () ) {
+		return dev.settle (MAX_WAIT);
+	}
+
+	// Ending up reimplementing artificial randomness... how ironic.
+	dev.step (MIN_WAIT + (fast_rng32() % RAND_WAIT));
+	return 0;
+}
+
+/* static unsigned int count_correct
+	(const uint64_t &expect, const uint64_t &observed, const uint64_t &mask, const uint16_t &cycle)
+
+	Number of correct output bits under 'mask'.
+	Oscillating circuits (cycle length above 1) score nothing, their output is only right by chance.
+*/
+static unsigned int count_correct
+(const uint64_t &expect, const uint64_t &observed, const uint64_t &mask, const uint16_t &cycle) {
+	if (cycle > 1) return 0;
+	return tt::bitcount64 ( ~(expect ^ observed) & mask );
+}
+
 
 
 /* ========== Miscellany Functions ========== */
@@ -59,12 +98,25 @@ unsigned int get_es_max (void) {
 
 /* ========== Evaluation Functions ========== */
 
+void eval_load (const uint32_t *const image) {
+	Backend &dev = *backend_get ();
+
+	dev.clear ();
+	dev.load_image (0, image);
+}
+
 unsigned int eval_com (const unsigned short &sel) {
 	const uint64_t *const input = tt::get_input();
 	const uint64_t *const expect = tt::get_output();
 	const uint16_t count = tt::get_row();
 	const uint64_t mask = tt::get_mask();
 
+	// First lane of the selected backend, loaded by eval_load()
+	Backend &dev = *backend_get ();
+
+	// Only simulate the cells which can reach a scored output
+	dev.set_cone (mask);
+
 	const float max_result = tt::get_max_bit();
 	float result = 0;
 
@@ -84,28 +136,26 @@ unsigned int eval_com (const unsigned short &sel) {
 	ORDER:
 	// In Given Order
 	for (unsigned short i = 0 ; i < count ; i++) {
-		fpga_set_input (input [i]);
+		dev.apply_input (input [i]);
 
-		// Ending up reimplementing artificial randomness... how ironic.
-		fpga_wind_clock (MIN_WAIT + (fast_rng32() % RAND_WAIT));
+		const uint16_t cycle = eval_wait (dev);
 
-		uint64_t observed = fpga_get_output ();
+		uint64_t observed = dev.read_output (0);
 
-		result += tt::bitcount64 ( ~(expect [i] ^ observed) & mask );
+		result += count_correct (expect [i], observed, mask, cycle);
 	}
 	goto END;
 
 	REVERSE:
 	// In Reverse Order
 	for (short i = count-1 ; i >= 0 ; i--) {
-		fpga_set_input (input [i]);
+		dev.apply_input (input [i]);
 
-		// Ending up reimplementing artificial randomness... how ironic.
-		fpga_wind_clock (MIN_WAIT + (fast_rng32() % RAND_WAIT));
+		const uint16_t cycle = eval_wait (dev);
 
-		uint64_t observed = fpga_get_output ();
+		uint64_t observed = dev.read_output (0);
 
-		result += tt::bitcount64 ( ~(expect [i] ^ observed) & mask );
+		result += count_correct (expect [i], observed, mask, cycle);
 	}
 	goto END;
 
@@ -113,14 +163,13 @@ unsigned int eval_com (const unsigned short &sel) {
 	// Random test
 	for (unsigned short i = 0 ; i < count ; i++) {
 		const unsigned short rng = fast_rng32() % count;
-		fpga_set_input (input [rng]);
+		dev.apply_input (input [rng]);
 
-		// Ending up reimplementing artificial randomness... how ironic.
-		fpga_wind_clock (MIN_WAIT + (fast_rng32() % RAND_WAIT));
+		const uint16_t cycle = eval_wait (dev);
 
-		uint64_t observed = fpga_get_output ();
+		uint64_t observed = dev.read_output (0);
 
-		result += tt::bitcount64 ( ~(expect [rng] ^ observed) & mask );
+		result += count_correct (expect [rng], observed, mask, cycle);
 	}
 
 	END:
@@ -133,19 +182,25 @@ unsigned int eval_seq (void) {
 	const uint16_t count = tt::get_row();
 	const uint64_t mask = tt::get_mask();
 
+	// First lane of the selected backend, loaded by eval_load()
+	Backend &dev = *backend_get ();
+
+	// Only simulate the cells which can reach a scored output
+	dev.set_cone (mask);
+
 	const float max_result = tt::get_max_bit() * MAX_SEQ_LOOP;
 	float result = 0;
 
 	// Repeats until a mistake is found, or the loop limit is reached
 	for (unsigned int j = 0 ; j < MAX_SEQ_LOOP ; j++) {
 		for (unsigned int i = 0 ; i < count ; i++) {
-			fpga_set_input (input [i]);
+			dev.apply_input (input [i]);
 
-			fpga_wind_clock (MIN_WAIT + (fast_rng32() % RAND_WAIT));
+			const uint16_t cycle = eval_wait (dev);
 
-			const uint64_t observed = fpga_get_output ();
+			const uint64_t observed = dev.read_output (0);
 
-			const unsigned int bits_correct = tt::bitcount64 ( ~(expect [i] ^ observed) & mask );
+			const unsigned int bits_correct = count_correct (expect [i], observed, mask, cycle);
 			result += bits_correct;
 
 			// Ends prematurely if a mistake is found
@@ -159,10 +214,187 @@ unsigned int eval_seq (void) {
 
 
 
+/* static void table_load (Backend &dev, const uint32_t *const *const image, const unsigned int &count,
+	const bool &keep)
+
+	Clears 'dev', then loads 'count' packed grids, one grid per lane.
+	Unused lanes are left with an empty RAM.
+	With 'keep', the cell outputs are kept instead, see Backend::replace().
+*/
+static void table_load (Backend &dev, const uint32_t *const *const image, const unsigned int &count,
+const bool &keep) {
+	if (keep) {
+		dev.replace ();
+	} else {
+		dev.clear ();
+	}
+
+	for (unsigned int k = 0 ; k < count ; k++) {
+		dev.load_image (k, image [k]);
+	}
+
+	// Only simulate the cells which can reach a scored output
+	dev.set_cone (tt::get_mask());
+}
+
+/* static void table_check (Backend &dev, const unsigned int &count,
+	const uint64_t &expect, const uint64_t &mask, const uint16_t &cycle, float *const result)
+
+	Adds the number of correct output bits of the first 'count' lanes to 'result [k]'.
+	Once a cycle is found by eval_wait(), lanes still changing are oscillating, and score nothing.
+*/
+static void table_check (Backend &dev, const unsigned int &count,
+const uint64_t &expect, const uint64_t &mask, const uint16_t &cycle, float *const result) {
+	for (unsigned int k = 0 ; k < count ; k++) {
+		if ( cycle > 1 && dev.get_unstable (k) ) continue;
+		result [k] += tt::bitcount64 ( ~(expect ^ dev.read_output (k)) & mask );
+	}
+}
+
+/* static void table_com (Backend &dev, const unsigned int &count, const unsigned short &sel, float *const result)
+	Same test as eval_com (sel), on the first 'count' lanes of 'dev'.
+*/
+static void table_com (Backend &dev, const unsigned int &count, const unsigned short &sel, float *const result) {
+	const uint64_t *const input = tt::get_input();
+	const uint64_t *const expect = tt::get_output();
+	const uint16_t row_count = tt::get_row();
+	const uint64_t mask = tt::get_mask();
+
+	for (unsigned short i = 0 ; i < row_count ; i++) {
+		unsigned short row;
+
+		switch (sel) {
+			case 0: row = i; break;
+			case 1: row = row_count - 1 - i; break;
+			default: row = fast_rng32() % row_count; break;
+		}
+
+		dev.apply_input (input [row]);
+		const uint16_t cycle = eval_wait (dev);
+		table_check (dev, count, expect [row], mask, cycle, result);
+	}
+}
+
+/* static void table_seq (Backend &dev, const unsigned int &count, float *const result)
+	Same test as eval_seq(), on the first 'count' lanes of 'dev'.
+*/
+static void table_seq (Backend &dev, const unsigned int &count, float *const result) {
+	const uint64_t *const input = tt::get_input();
+	const uint64_t *const expect = tt::get_output();
+	const uint16_t row_count = tt::get_row();
+	const uint64_t mask = tt::get_mask();
+
+	// Repeats the truth table up to the loop limit
+	for (unsigned int j = 0 ; j < MAX_SEQ_LOOP ; j++) {
+		for (unsigned int i = 0 ; i < row_count ; i++) {
+			dev.apply_input (input [i]);
+			const uint16_t cycle = eval_wait (dev);
+			table_check (dev, count, expect [i], mask, cycle, result);
+		}
+	}
+}
+
+/* static void table_run (Backend &dev, const unsigned int &used, unsigned int *const score)
+	Scores the first 'used' lanes of 'dev', already loaded, writes them to 'score'.
+*/
+static void table_run (Backend &dev, const unsigned int &used, unsigned int *const score) {
+	// Same test sequence as eval_com() in sim_run() -- ORDER, REVERSE, then 3 RANDOM
+	const unsigned short sequence [5] = {0, 1, 2, 2, 2};
+
+	if (tt::get_mode() == 0) {
+		const float max_result = tt::get_max_bit();
+
+		for (unsigned int k = 0 ; k < used ; k++) {
+			score [k] = 0;
+		}
+
+		for (unsigned int t = 0 ; t < 5 ; t++) {
+			float result [BACKEND_MAX_LANES] = {0};
+
+			table_com (dev, used, sequence [t], result);
+
+			for (unsigned int k = 0 ; k < used ; k++) {
+				score [k] += (unsigned int) (SCORE_MAX * (result [k] / max_result));
+			}
+		}
+
+		for (unsigned int k = 0 ; k < used ; k++) {
+			score [k] /= 5;
+		}
+	} else {
+		const float max_result = tt::get_max_bit() * MAX_SEQ_LOOP;
+		float result [BACKEND_MAX_LANES] = {0};
+
+		table_seq (dev, used, result);
+
+		for (unsigned int k = 0 ; k < used ; k++) {
+			score [k] = (unsigned int) (SCORE_MAX * (result [k] / max_result));
+		}
+	}
+}
+
+void eval_table (Backend &dev, const uint32_t *const *const image, const unsigned int &count,
+unsigned int *const score, const bool *const settles) {
+	const unsigned int lanes = dev.get_lanes ();
+
+	for (unsigned int base = 0 ; base < count ; base += lanes) {
+		const unsigned int used = (count - base > lanes) ? lanes : (count - base);
+
+		// Only grids which settle from any state may start from the outputs of the previous ones
+		bool keep = (settles != NULL);
+
+		for (unsigned int k = 0 ; keep && k < used ; k++) {
+			keep = settles [base + k];
+		}
+
+		table_load (dev, &image [base], used, keep);
+		table_run (dev, used, &score [base]);
+	}
+}
+
+bool eval_settles (const uint8_t *const *const grid) {
+	net.compile (grid, tt::get_mask());
+
+	// Settled by the shortest wait of eval_com() / eval_seq(), whatever the state before
+	return ( net.get_loop_count () == 0 && net.get_depth () <= MIN_WAIT - 1 );
+}
+
+
+bool eval_net (const uint8_t *const *const grid, unsigned int &score) {
+	const uint64_t *const input = tt::get_input();
+	const uint64_t *const expect = tt::get_output();
+	const uint16_t count = tt::get_row();
+	const uint64_t mask = tt::get_mask();
+
+	// Only exact for loop-free circuits, settled by the shortest wait of eval_com() / eval_seq()
+	if ( eval_settles (grid) == 0 ) return 0;
+
+	const float max_result = tt::get_max_bit();
+	float result = 0;
+
+	// Up to NET_LANES truth table rows per pass
+	for (unsigned int base = 0 ; base < count ; base += NET_LANES) {
+		const unsigned int lanes = (count - base > NET_LANES) ? NET_LANES : (count - base);
+
+		net.set_input (&input [base], lanes);
+		net.settle (1);
+		result += net.count_correct (&expect [base], mask);
+	}
+
+	score = (unsigned int) (SCORE_MAX * (result / max_result));
+	return 1;
+}
+
+
+
 /* ========== Inspect Evaluation Functions ========== */
 
-void print_table (const uint64_t &input, const uint64_t &expect, const uint64_t &observed) {
-	if ( (observed & tt::get_mask()) == (expect & tt::get_mask()) ) {
+void print_table
+(const uint64_t &input, const uint64_t &expect, const uint64_t &observed, const uint16_t &cycle) {
+	if (cycle > 1) {
+		printf ("\t0x%016llX | 0x%016llX | " ANSI_RED "0x%016llX | Oscillating, cycle %u\n" ANSI_RESET,
+			input, expect, observed & tt::get_mask(), cycle );
+	} else if ( (observed & tt::get_mask()) == (expect & tt::get_mask()) ) {
 		printf ("\t0x%016llX | 0x%016llX | " ANSI_GREEN "0x%016llX\n" ANSI_RESET,
 			input, expect, observed & tt::get_mask() );
 	} else {
@@ -177,6 +409,12 @@ unsigned int eval_com_insp (const unsigned short &sel) {
 	const uint16_t count = tt::get_row();
 	const uint64_t mask = tt::get_mask();
 
+	// First lane of the selected backend, loaded by eval_load()
+	Backend &dev = *backend_get ();
+
+	// Only simulate the cells which can reach a scored output
+	dev.set_cone (mask);
+
 	const float max_result = tt::get_max_bit();
 	float result = 0;
 
@@ -206,32 +444,30 @@ unsigned int eval_com_insp (const unsigned short &sel) {
 	ORDER:
 	// In Given Order
 	for (unsigned short i = 0 ; i < count ; i++) {
-		fpga_set_input (input [i]);
+		dev.apply_input (input [i]);
 
-		// Ending up reimplementing artificial randomness... how ironic.
-		fpga_wind_clock (MIN_WAIT + (fast_rng32() % RAND_WAIT));
+		const uint16_t cycle = eval_wait (dev);
 
-		uint64_t observed = fpga_get_output ();
+		uint64_t observed = dev.read_output (0);
 
-		result += tt::bitcount64 ( ~(expect [i] ^ observed) & mask );
+		result += count_correct (expect [i], observed, mask, cycle);
 
-		print_table (input[i], expect[i], observed);
+		print_table (input[i], expect[i], observed, cycle);
 	}
 	goto END;
 
 	REVERSE:
 	// In Reverse Order
 	for (short i = count-1 ; i >= 0 ; i--) {
-		fpga_set_input (input [i]);
+		dev.apply_input (input [i]);
 
-		// Ending up reimplementing artificial randomness... how ironic.
-		fpga_wind_clock (MIN_WAIT + (fast_rng32() % RAND_WAIT));
+		const uint16_t cycle = eval_wait (dev);
 
-		uint64_t observed = fpga_get_output ();
+		uint64_t observed = dev.read_output (0);
 
-		result += tt::bitcount64 ( ~(expect [i] ^ observed) & mask );
+		result += count_correct (expect [i], observed, mask, cycle);
 
-		print_table (input[i], expect[i], observed);
+		print_table (input[i], expect[i], observed, cycle);
 	}
 	goto END;
 
@@ -239,16 +475,15 @@ unsigned int eval_com_insp (const unsigned short &sel) {
 	// Random test
 	for (unsigned short i = 0 ; i < count ; i++) {
 		const unsigned short rng = fast_rng32() % count;
-		fpga_set_input (input [rng]);
+		dev.apply_input (input [rng]);
 
-		// Ending up reimplementing artificial randomness... how ironic.
-		fpga_wind_clock (MIN_WAIT + (fast_rng32() % RAND_WAIT));
+		const uint16_t cycle = eval_wait (dev);
 
-		uint64_t observed = fpga_get_output ();
+		uint64_t observed = dev.read_output (0);
 
-		result += tt::bitcount64 ( ~(expect [rng] ^ observed) & mask );
+		result += count_correct (expect [rng], observed, mask, cycle);
 
-		print_table (input[rng], expect[rng], observed);
+		print_table (input[rng], expect[rng], observed, cycle);
 	}
 
 	END:
@@ -262,6 +497,12 @@ unsigned int eval_seq_insp (void) {
 	const uint16_t count = tt::get_row();
 	const uint64_t mask = tt::get_mask();
 
+	// First lane of the selected backend, loaded by eval_load()
+	Backend &dev = *backend_get ();
+
+	// Only simulate the cells which can reach a scored output
+	dev.set_cone (mask);
+
 	const float max_result = tt::get_max_bit() * MAX_SEQ_LOOP;
 	float result = 0;
 	unsigned int loop_count = 0;
@@ -274,16 +515,16 @@ unsigned int eval_seq_insp (void) {
 	// Repeats until a mistake is found, or the loop limit is reached
 	for (unsigned int i = 0 ; i < MAX_SEQ_LOOP ; i++) {
 		for (unsigned int i = 0 ; i < count ; i++) {
-			fpga_set_input (input [i]);
+			dev.apply_input (input [i]);
 
-			fpga_wind_clock (MIN_WAIT + (fast_rng32() % RAND_WAIT));
+			const uint16_t cycle = eval_wait (dev);
 
-			const uint64_t observed = fpga_get_output ();
+			const uint64_t observed = dev.read_output (0);
 
-			const unsigned int bits_correct = tt::bitcount64 ( ~(expect [i] ^ observed) & mask );
+			const unsigned int bits_correct = count_correct (expect [i], observed, mask, cycle);
 			result += bits_correct;
 
-			print_table (input[i], expect[i], observed);
+			print_table (input[i], expect[i], observed, cycle);
 
 			// Ends prematurely if a mistake is found
 			// if (bits_correct != tt::get_mask_bc()) goto END;
@@ -305,8 +546,13 @@ unsigned int eval_seq_insp (void) {
 uint16_t eval_efficiency (const uint8_t *const *const grid) {
 	uint16_t penalty = 0;
 
+	// Gates outside the cone of influence of the scored outputs do not matter
+	uint64_t cone [PHYSICAL_DIMY];
+	lca_cone (grid, tt::get_mask(), cone);
+
 	for (uint16_t y = 0 ; y < PHYSICAL_DIMY ; y++) {
 		for (uint16_t x = 0 ; x < PHYSICAL_DIMX ; x++) {
+			if ( ((cone [y] >> x) & 0x1) == 0 ) continue;
 
 			// Add other values in here to penalize those settings
 			if (grid[y][x] == 3) penalty += 1; // Penalize NAND Gates
@@ -332,8 +578,8 @@ float fpos = 0;
 float fneg = 0;
 
 for (unsigned int i = 0 ; i < count ; i++) {
-	fpga_set_input (input [i]);
-	uint64_t observed = fpga_get_output ();
+	dev.apply_input (input [i]);
+	uint64_t observed = dev.read_output (0);
 
 	// Sums True Positive, False Positive, False Negative
 	// Special case: If no bits are expected (expecting 0x00000000),
@@ -6,6 +6,9 @@
 #ifndef EVAL_HPP
 #define EVAL_HPP
 
+// Evaluation Backend -- See backend.hpp
+class Backend;
+
 /* ========== Miscellany Functions ========== */
 
 /* unsigned int get_score_max (void)
@@ -22,8 +25,14 @@ unsigned int get_es_max (void);
 
 /* ========== Evaluation Functions ========== */
 
+/* void eval_load (const uint32_t *const image);
+	Clears the selected backend (backend.hpp), then loads a packed grid (global.hpp) into its first lane.
+	Used before eval_com() / eval_seq() and the inspect functions, which run on that lane.
+*/
+void eval_load (const uint32_t *const image);
+
 /* unsigned int eval_com (const unsigned short &sel);
-	Evaluation for combinational logic.
+	Evaluation for combinational logic, on the selected backend.
 	Tests the truth table in random different orders, should be random enough to stop overfitting
 
 	Counts the number of correct bits over the entire test,
@@ -43,6 +52,50 @@ unsigned int eval_com (const unsigned short &sel);
 */
 unsigned int eval_seq (void);
 
+/* void eval_table (Backend &dev, const uint32_t *const *const image, const unsigned int &count,
+	unsigned int *const score, const bool *const settles = NULL);
+
+	Evaluates 'count' packed grids (global.hpp) against the current truth table, on backend 'dev'.
+	Grids are loaded as many at a time as 'dev' has lanes, one per lane,
+	every lane is given the same input sequence and clock timing.
+
+	The cell outputs are reset before every load, see Backend::clear().
+	If given, 'settles [k]' is eval_settles() of 'image [k]' -- When every grid of a load settles,
+	the outputs are kept, and only the changed RAM words are written, see Backend::replace().
+
+	Combinational logic: Same tests as eval_com(), ORDER, REVERSE, and 3 RANDOM, averaged.
+	Sequential logic: Same test as eval_seq().
+
+	The score of 'image [k]' is written to 'score [k]', same scale as eval_com().
+*/
+void eval_table (Backend &dev, const uint32_t *const *const image, const unsigned int &count,
+	unsigned int *const score, const bool *const settles = NULL);
+
+/* bool eval_settles (const uint8_t *const *const grid);
+	Returns 1 if the cone of influence of the truth table mask reaches the same outputs from any
+	cell state, within the shortest wait between two inputs of eval_com() / eval_seq():
+	it has no feedback loops, and is less than MIN_WAIT cells deep. See the netlist, net.hpp.
+*/
+bool eval_settles (const uint8_t *const *const grid);
+
+/* bool eval_net (const uint8_t *const *const grid, unsigned int &score);
+	Netlist evaluation, for combinational or sequential logic. Does not use the FPGA.
+	Compiles the cone of influence of the truth table mask into a netlist (net.hpp),
+	then evaluates every truth table row with a single pass over its instructions.
+
+	Only used when the result is exactly what the Cell Array would give:
+	the cone has no feedback loops, and settles within the shortest wait between two inputs.
+	Every test of eval_com() / eval_seq() then sees the same output for the same input,
+	in any order, or in the settle evaluation mode.
+	The RANDOM test of eval_com() picks rows with replacement, its score is only noisier --
+	the netlist score is the same as the ORDER and REVERSE tests.
+
+	Returns 1 and writes the score to 'score', same scale as eval_com().
+	Returns 0 and leaves 'score' untouched if the netlist cannot be used.
+	Only taken with the software backend -- The FPGA and the mock device evaluate every circuit.
+*/
+bool eval_net (const uint8_t *const *const grid, unsigned int &score);
+
 
 
 /* ========== Inspect Evaluation Functions ==========
@@ -67,6 +120,7 @@ unsigned int eval_seq_insp (void);
 	Efficiency evaluation metric.
 	Set to evaluate which solution is more gate efficient.
 	Using less number of gate is better.
+	Only gates inside the cone of influence of the truth table mask are counted -- See lca.hpp.
 */
 uint16_t eval_efficiency (const uint8_t *const *const grid);
 
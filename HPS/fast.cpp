@@ -58,9 +58,10 @@ static inline uint32_t rotl (const uint32_t x, int k) {
 	return (x << k) | (x >> (32 - k));
 }
 
-static uint32_t s[4];
+// One generator per thread -- Worker threads switch streams through rng32()
+static thread_local Xoshiro128ss rng;
 
-static uint32_t next (void) {
+uint32_t Xoshiro128ss::next (void) {
 	const uint32_t result_starstar = rotl(s[0] * 5, 7) * 9;
 
 	const uint32_t t = s[1] << 9;
@@ -82,7 +83,7 @@ static uint32_t next (void) {
    non-overlapping subsequences for parallel computations.
 */
 
-static void jump (void) {
+void Xoshiro128ss::jump (void) {
 	static const uint32_t JUMP[] = { 0x8764000b, 0xf542d2d3, 0x6fa035c3, 0x77f2db5b };
 
 	uint32_t s0 = 0;
@@ -106,6 +107,36 @@ static void jump (void) {
 	s[3] = s3;
 }
 
+/* This is the long-jump function for the generator. It is equivalent to
+   2^96 calls to next(); it can be used to generate 2^32 starting points,
+   from each of which jump() will generate 2^32 non-overlapping
+   subsequences for parallel distributed computations.
+*/
+
+void Xoshiro128ss::long_jump (void) {
+	static const uint32_t LONG_JUMP[] = { 0xb523952e, 0x0b6f099f, 0xccf5a0ef, 0x1c580662 };
+
+	uint32_t s0 = 0;
+	uint32_t s1 = 0;
+	uint32_t s2 = 0;
+	uint32_t s3 = 0;
+	for(uint32_t i = 0; i < sizeof LONG_JUMP / sizeof *LONG_JUMP; i++)
+		for(int b = 0; b < 32; b++) {
+			if (LONG_JUMP[i] & UINT32_C(1) << b) {
+				s0 ^= s[0];
+				s1 ^= s[1];
+				s2 ^= s[2];
+				s3 ^= s[3];
+			}
+			next();
+		}
+
+	s[0] = s0;
+	s[1] = s1;
+	s[2] = s2;
+	s[3] = s3;
+}
+
 
 /* ========== RNG SEED GENERATOR - SPLITMIX64 ========== */
 
@@ -130,9 +161,7 @@ static void jump (void) {
 */
 
 /* Split Mix State -- The state can be seeded with any value. */
-static uint64_t sms;
-
-static uint64_t splitmix64 (void) {
+static uint64_t splitmix64 (uint64_t &sms) {
 	uint64_t z = (sms += 0x9e3779b97f4a7c15);
 	z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9;
 	z = (z ^ (z >> 27)) * 0x94d049bb133111eb;
@@ -142,8 +171,39 @@ static uint64_t splitmix64 (void) {
 
 /* ========== HANDLING FUNCTIONS ========== */
 
+Xoshiro128ss::Xoshiro128ss (const uint32_t &seed) {
+	// Use SplitMix64 to set Xoshiro128** seeds
+	uint64_t sms = seed;
+	s[0] = splitmix64 (sms);
+	s[1] = splitmix64 (sms);
+	s[2] = splitmix64 (sms);
+	s[3] = splitmix64 (sms);
+
+	// Jump once to randomize Xoshiro128** even more
+	jump ();
+}
+
 uint32_t fast_rng32 (void) {
-	return next ();
+	return rng.next ();
+}
+
+uint32_t fast_rng32 (const uint32_t &range) {
+	uint64_t m = (uint64_t) rng.next () * range;
+
+	// Low half below 'range' -- Might be one of the biased values, (2^32 % range) of them
+	if ((uint32_t) m < range) {
+		const uint32_t threshold = (0 - range) % range;
+
+		while ((uint32_t) m < threshold) {
+			m = (uint64_t) rng.next () * range;
+		}
+	}
+
+	return m >> 32;
+}
+
+Xoshiro128ss &rng32 (void) {
+	return rng;
 }
 
 void seed_rng32 (void) {
@@ -151,14 +211,13 @@ void seed_rng32 (void) {
 	srand(time(NULL));
 
 	// Set SplitMix64 seed
-	sms = rand ();
+	seed_rng32 (rand ());
+}
 
-	// Use SplitMix64 to set Xoshiro128** seeds
-	s[0] = splitmix64 ();
-	s[1] = splitmix64 ();
-	s[2] = splitmix64 ();
-	s[3] = splitmix64 ();
+void seed_rng32 (const uint32_t &seed) {
+	// Set std::rand() seed
+	srand(seed);
 
-	// Jump once to randomize Xoshiro128** even more
-	jump ();
+	// Seeds this thread's Xoshiro128** through SplitMix64
+	rng = Xoshiro128ss (seed);
 }
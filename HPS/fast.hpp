@@ -18,6 +18,51 @@ unsigned int fast_pow (const unsigned short &base, const unsigned short &expo);
 /* ========== FAST RNG - XOSHIRO128** ========== */
 // Code from: http://xoshiro.di.unimi.it/
 
+/* class Xoshiro128ss
+	xoshiro128** PRNG as an object, a stream of its own. The same generator as fast_rng32(),
+	which is simply the calling thread's own object, see rng32().
+
+	32-bit PRNG, with 128-bit state size. Objects can be copied, a copy continues the same stream.
+	Independent streams are split off with jump() and long_jump():
+
+		jump ()      -- Same as 2^64 calls to next(), 2^64 non-overlapping streams
+		long_jump () -- Same as 2^96 calls to next(), 2^32 starting points for jump()
+
+	The default constructor leaves the state uninitialized, it must be seeded or assigned.
+*/
+class Xoshiro128ss {
+
+public:
+
+	// Generator state -- Must not be everywhere zero
+	uint32_t s [4];
+
+	/* Xoshiro128ss (void)
+		Uninitialized state -- Trivial, so the per-thread object of fast_rng32() is free to access.
+	*/
+	Xoshiro128ss (void) = default;
+
+	/* Xoshiro128ss (const uint32_t &seed)
+		Seeds the state through SplitMix64, then jumps once. Same stream as seed_rng32 (seed).
+	*/
+	explicit Xoshiro128ss (const uint32_t &seed);
+
+	/* uint32_t next (void)
+		Returns the next 32-bit number of the stream.
+	*/
+	uint32_t next (void);
+
+	/* void jump (void)
+		Advances the stream by 2^64 numbers.
+	*/
+	void jump (void);
+
+	/* void long_jump (void)
+		Advances the stream by 2^96 numbers.
+	*/
+	void long_jump (void);
+};
+
 /* unsigned int fast_rng32 (void)
 	Wrapper function for calling xoshiro128** PRNG.
 	Returns unsigned int result
@@ -28,6 +73,19 @@ unsigned int fast_pow (const unsigned short &base, const unsigned short &expo);
 */
 unsigned int fast_rng32 (void);
 
+/* unsigned int fast_rng32 (const unsigned int &range)
+	Unbiased random number in [0, range), from the same PRNG as fast_rng32(). 'range' must not be 0.
+	Lemire's multiply-shift method: the high half of a 32 x 32-bit product, instead of a division.
+	Only the rare draws landing in the (2^32 % range) biased values are redrawn -- Never for a power of 2.
+*/
+unsigned int fast_rng32 (const unsigned int &range);
+
+/* Xoshiro128ss &rng32 (void)
+	Returns the calling thread's PRNG, the one used by fast_rng32().
+	Assigning to it switches the calling thread over to another stream.
+*/
+Xoshiro128ss &rng32 (void);
+
 /* void seed_rng32 (void)
 	Wrapper function for setting PRNG seeds.
 
@@ -40,6 +98,12 @@ unsigned int fast_rng32 (void);
 */
 void seed_rng32 (void);
 
+/* void seed_rng32 (const unsigned int &seed)
+	Same as above, with a fixed seed for std::rand() and splitmix64().
+	The same seed always gives the same sequence, for reproducible simulations.
+*/
+void seed_rng32 (const unsigned int &seed);
+
 
 
 #endif
@@ -8,6 +8,10 @@
 	Define the flag with makefile to compile a different version for PC.
 	The PC_BUILD version will not have access to the FPGA.
 	This allows debug builds to be ran on PC, instead of on the DE0-nano-SoC
+
+	Instead, the PC_BUILD version always maps the mock Avalon device (mock.hpp).
+	The same register-level code runs on both builds, only the mapped memory is different.
+	The ARM build maps the mock instead of /dev/mem when the Mock backend is selected.
 */
 
 /* Notes on Endianness - FPGA module is designed as little-endian
@@ -22,13 +26,14 @@
 #include <stdio.h>		// printf
 #include <stdlib.h>		// calloc, free, itoa
 #include <stdint.h>		// uint definitions
+#include <time.h>		// clock_gettime
 
 
 /* ========== Linux API Include ========== */
 
-#include <unistd.h>
-#include <fcntl.h>
-#include <sys/mman.h>
+#include <unistd.h>		// close, usleep
+#include <fcntl.h>		// open
+#include <sys/mman.h>	// mmap, munmap
 
 
 /* ========== Altera HWLIB Include ========== */
@@ -41,6 +46,15 @@
 	#include "socal/alt_gpio.h"
 	#include "hps_0.h"
 
+#else
+
+	// Stand-ins for the Altera HWLIB accessors -- Volatile memory access, same as hwlib.h
+	#define alt_read_word(src) (*(volatile uint32_t *)(src))
+	#define alt_write_word(dest, src) (*(volatile uint32_t *)(dest) = (src))
+	#define alt_write_hword(dest, src) (*(volatile uint16_t *)(dest) = (src))
+	#define alt_read_hword(src) (*(volatile uint16_t *)(src))
+	#define alt_read_byte(src) (*(volatile uint8_t *)(src))
+
 #endif
 
 
@@ -48,7 +62,9 @@
 
 #include "fpga.hpp"
 #include "ansi.hpp"
+#include "ca.hpp"
 #include "global.hpp"
+#include "mock.hpp"
 
 
 /* ========== FPGA Define ========== */
@@ -59,42 +75,17 @@
 	#define HW_REGS_SPAN ( 0x04000000 )
 	#define HW_REGS_MASK ( HW_REGS_SPAN - 1 )
 
-	/* Avalon Slave Ports
-		The Cell Array module contains these Avalon Slave Ports.
-		Port 1 -- Linux IO
-		Port 2 -- RAM
-		Port 3 -- Clock Control
-	*/
-
-	// --- S1 | Linux In / Out --- //
-	#define S_IO		0x1000
-	#define SIO_RANGE 2
-
-	// --- S2 | Cell RAM --- //
-	#define S_RAM		0x2000
-	#define SRAM_RANGE 512
-
-	// --- S3 | Wind-up Clock --- //
-	#define S_CLK		0x0000
-	#define CYCLES_PER_USEC 100
-
-	/* --- Version ROM ---
-		This ROM module is used to keep track of what the FPGA configuration is.
-		Each FPGA config build will have a unique version number, embedded at compile time.
-	*/
-	#define VROM_ADDR		0x10000
-	#define VROM_RANGE 16
+#endif
 
-	// Avalon Slave Port Data Width (Bits)
-	#define AVALON_PORT_WIDTH 32
+// Wind-up clock speed -- Cell Array clock cycles per microsecond
+#define CYCLES_PER_USEC 100
 
-	// FPGA Array Cell Data Width (Bits) -- fpga_set_grid
-	#define CELL_DATA_WIDTH 4
+// Busy loop iterations timed by the spin-wait calibration -- See fpga_calibrate_spin()
+#define SPIN_CALIBRATE 1000000
 
-	// Numbers of Cells able to fit in the buffer -- fpga_set_grid
-	#define CELL_IN_BUFFER (AVALON_PORT_WIDTH / CELL_DATA_WIDTH)
+// Avalon Slave Port Data Width (Bits)
+#define AVALON_PORT_WIDTH 32
 
-#endif
 
 
 /* ========== FPGA Global Variables ========== */
@@ -107,15 +98,43 @@
 	// DEV/MEM/
 	static int fd;
 
-	// Pointer for Avalon Slave Devices
-	static uint32_t *sio_addr;
-	static uint32_t *sram_addr;
-	static uint16_t *sclk_addr;
+#endif
 
-	// Version ROM pointer
-	static uint8_t *vrom_address;
+// Pointer for Avalon Slave Devices
+static uint32_t *sio_addr;
+static uint32_t *sout_addr;
+static uint32_t *sram_addr;
+static uint16_t *sclk_addr;
 
-#endif
+// Version ROM pointer
+static uint8_t *vrom_address;
+
+// Mapped to the mock Avalon device, instead of the FPGA
+static bool fpga_mock_flag;
+
+/* Shadow of the Cell RAM -- Last word written to each S2 offset
+	Invalid until the whole RAM has been written once, see fpga_s2_update().
+*/
+static uint32_t s2_shadow [SRAM_RANGE];
+static bool s2_shadow_valid;
+
+// Wind-up clock wait strategy -- Local copy of GlobalSettings, see fpga_wind_clock()
+static unsigned int wait_mode;
+
+// Calibrated spin-wait -- Busy loop iterations per microsecond
+static uint32_t spin_per_usec = 1;
+
+/* Wind-up clock wait instrumentation -- See fpga_idle_report()
+	Time spent waiting for the Cell Array, since fpga_idle_reset().
+*/
+struct wait_stats {
+	uint64_t start;
+	uint64_t idle;
+	uint32_t waits;
+	uint32_t timeouts;
+};
+
+static wait_stats idle;
 
 // Local Copy of Global Parameters
 static uint16_t dimx;
@@ -145,70 +164,177 @@ using namespace std;
 	 *
 */
 
-#ifndef PC_BUILD
+/* The mock device adds its modelled bus latency to every access -- See mock.hpp */
 
 uint32_t fpga_s1_read (const uint32_t &offset) {
-	return alt_read_word (sio_addr + offset);
+	if (fpga_mock_flag) mock_access (0);
+	return alt_read_word (sout_addr + offset);
 }
 
 void fpga_s1_write (const uint32_t &offset, const uint32_t &data) {
+	if (fpga_mock_flag) mock_access (1);
 	alt_write_word (sio_addr + offset, data);
 }
 
 void fpga_s2_write (const uint32_t &offset, const uint32_t &data) {
+	if (fpga_mock_flag) mock_access (1);
 	alt_write_word (sram_addr + offset, data);
 }
 
+uint16_t fpga_s3_read (void) {
+	if (fpga_mock_flag) mock_access (0);
+	return alt_read_hword (sclk_addr);
+}
+
 void fpga_s3_write (const uint16_t &data) {
+	if (fpga_mock_flag) mock_access (1);
 	alt_write_hword (sclk_addr, data);
+
+	// The mock device runs its clock once wound up, on its own thread
+	if (fpga_mock_flag) mock_service ();
 }
 
 uint8_t fpga_vrom_read (const uint32_t &offset) {
+	if (fpga_mock_flag) mock_access (0);
 	return alt_read_byte (vrom_address + offset);
 }
 
-#endif
+/* static void fpga_s2_update (const uint32_t &offset, const uint32_t &data)
+	Writes 'data' to S2, unless the RAM already holds it -- Checked against the shadow.
+*/
+static void fpga_s2_update (const uint32_t &offset, const uint32_t &data) {
+	if (s2_shadow_valid && s2_shadow [offset] == data) return;
 
+	fpga_s2_write (offset, data);
+	s2_shadow [offset] = data;
+}
 
-/* ========== Main Functions ========== */
 
-#ifdef PC_BUILD
+/* ========== Wait Helper Functions ========== */
 
-void fpga_init (void) {
-	printf ("PC Build FPGA Init ");
+/* static uint64_t fpga_now (void)
+	Monotonic time in nanoseconds.
+*/
+static uint64_t fpga_now (void) {
+	timespec now;
+	clock_gettime (CLOCK_MONOTONIC, &now);
+	return (uint64_t) now.tv_sec * 1000000000ULL + now.tv_nsec;
+}
 
-	dimx = GlobalSettings::get_ca_dimx ();
-	dimy = GlobalSettings::get_ca_dimy ();
-	fpga_init_flag = 1;
+/* static void fpga_spin (const uint32_t &loops)
+	Busy loop -- volatile, so the compiler keeps every iteration.
+*/
+static void fpga_spin (const uint32_t &loops) {
+	for (volatile uint32_t i = 0 ; i < loops ; i++);
+}
 
-	printf (ANSI_GREEN "OK\n" ANSI_RESET);
-	return;
+/* static void fpga_calibrate_spin (void)
+	Times SPIN_CALIBRATE iterations of fpga_spin(), to spin for a given time without a clock read.
+	Takes the fastest of a few runs, to leave out preemption.
+*/
+static void fpga_calibrate_spin (void) {
+	uint64_t best = UINT64_MAX;
+
+	for (unsigned int run = 0 ; run < 5 ; run++) {
+		const uint64_t start = fpga_now ();
+		fpga_spin (SPIN_CALIBRATE);
+		const uint64_t time = fpga_now () - start;
+
+		if (time < best) best = time;
+	}
+
+	spin_per_usec = (uint32_t) ((uint64_t) SPIN_CALIBRATE * 1000 / (best + 1));
+	if (spin_per_usec == 0) spin_per_usec = 1;
 }
 
-void fpga_cleanup (void) {
-	printf ("PC Build FPGA Cleanup ");
 
-	fpga_init_flag = 0;
 
-	printf (ANSI_GREEN "OK\n" ANSI_RESET);
-	return;
+/* ========== Main Functions ========== */
+
+/* static void fpga_map (char *const bridge)
+	Assigns the Avalon slave port pointers, from the base of the Lightweight HPS-to-FPGA bridge.
+
+	Notes on all the type casts
+	Cast to (char *) to suppress arithmetic with (void*) warning,
+	then cast results back into (unsigned long *) to work properly
+
+	Cannot cast virtual_base directly to (unsigned long *) because pointer arithmetic:
+		> long int *p + 1 == *p + 4 << Causes int overflow and SEGFAULTs
+		> char *q + 1 == *q + 1
+	See: http://www.cplusplus.com/doc/tutorial/pointers/#arithmetics
+	Also: https://groups.google.com/forum/#!topic/comp.lang.c/RRsX0Z3MUjY%5B1-25%5D
+*/
+static void fpga_map (char *const bridge) {
+	sio_addr = (uint32_t *) (bridge + S_IO);
+	sram_addr = (uint32_t *) (bridge + S_RAM);
+	sclk_addr = (uint16_t *) (bridge + S_CLK);
+	vrom_address = (uint8_t *) (bridge + VROM_ADDR);
+
+	// Unknown RAM contents -- The FPGA keeps its RAM between two runs of the program
+	s2_shadow_valid = 0;
+
+	/* The FPGA reads the output from the same address the input is written to.
+		Memory cannot tell a read from a write, so the mock keeps its output right after the input.
+	*/
+	sout_addr = (fpga_mock_flag) ? (sio_addr + SIO_RANGE) : sio_addr;
 }
 
-#else
+/* static void fpga_unmap (void)
+	Releases the memory mapped by fpga_init(), if any.
+*/
+static void fpga_unmap (void) {
+	if (fpga_init_flag == 0) return;
+
+	if (fpga_mock_flag) {
+		mock_cleanup ();
+	} else {
+		#ifndef PC_BUILD
+		munmap (virtual_base, HW_REGS_SPAN);
+		close (fd);
+		#endif
+	}
+
+	fpga_init_flag = 0;
+}
 
 void fpga_init (void) {
 	printf ("Initializing FPGA... ");
 
 	// If FPGA was already initialized, close and reinitialize.
-	if ( fpga_init_flag == 1 ) {
-		close (fd);
-		fpga_init_flag = 0;
-	}
+	fpga_unmap ();
 
 	// Creates local copy of global parameters for CA functions
 	dimx = GlobalSettings::get_ca_dimx ();
 	dimy = GlobalSettings::get_ca_dimy ();
 
+	wait_mode = GlobalSettings::get_eval_wait ();
+	if (wait_mode == WAIT_SPIN) fpga_calibrate_spin ();
+	fpga_idle_reset ();
+
+	// The PC build has no FPGA -- Always uses the mock device
+	#ifdef PC_BUILD
+	fpga_mock_flag = 1;
+	#else
+	fpga_mock_flag = (GlobalSettings::get_eval_backend () == BACKEND_MOCK);
+	#endif
+
+	if (fpga_mock_flag) {
+		char *const bridge = (char *) mock_init ();
+
+		if (bridge == NULL) {
+			printf (ANSI_RED "MOCK DEVICE FAIL\n" ANSI_RESET);
+			return;
+		}
+
+		fpga_map (bridge);
+		fpga_init_flag = 1;
+		fpga_clear ();
+		printf (ANSI_GREEN "MOCK DEVICE\n" ANSI_RESET);
+		return;
+	}
+
+	#ifndef PC_BUILD
+
 	// Read Device Memory
 	fd = open ("/dev/mem", (O_RDWR | O_SYNC));
 
@@ -229,40 +355,24 @@ void fpga_init (void) {
 		return;
 	}
 
-	/* Assign address pointers
-		Notes on all the type casts
-		Cast virtual_base to (char *) to suppress arithmetic with (void*) warning,
-		then cast results back into (unsigned long *) to work properly
-
-		Cannot cast virtual_base directly to (unsigned long *) because pointer arithmetic:
-			> long int *p + 1 == *p + 4 << Causes int overflow and SEGFAULTs
-			> char *q + 1 == *q + 1
-		See: http://www.cplusplus.com/doc/tutorial/pointers/#arithmetics
-		Also: https://groups.google.com/forum/#!topic/comp.lang.c/RRsX0Z3MUjY%5B1-25%5D
-	*/
-	sio_addr = (uint32_t *)( (char *)(virtual_base)
-		+ ((ALT_LWFPGASLVS_OFST + S_IO) & HW_REGS_MASK) );
-	sram_addr = (uint32_t *)( (char *)(virtual_base)
-		+ ((ALT_LWFPGASLVS_OFST + S_RAM) & HW_REGS_MASK) );
-	sclk_addr = (uint16_t *)( (char *)(virtual_base)
-		+ ((ALT_LWFPGASLVS_OFST + S_CLK) & HW_REGS_MASK) );
-
-	vrom_address = (uint8_t *)( (char *)(virtual_base)
-		+ ((ALT_LWFPGASLVS_OFST + VROM_ADDR) & HW_REGS_MASK) );
+	// Assign address pointers
+	fpga_map ( (char *)(virtual_base) + (ALT_LWFPGASLVS_OFST & HW_REGS_MASK) );
 
 	fpga_init_flag = 1;
 	fpga_clear ();
 	printf (ANSI_GREEN "DONE\n" ANSI_RESET);
+
+	#endif
+
 	return;
 }
 
 void fpga_cleanup (void) {
 	printf ("Cleaning up FPGA... ");
 
-	// If FPGA has been initialized, close fd
-	if (fpga_init_flag == 1) close (fd);
+	// If FPGA has been initialized, release the mapped memory
+	fpga_unmap ();
 
-	fpga_init_flag = 0;
 	printf (ANSI_GREEN "DONE\n" ANSI_RESET);
 	return;
 }
@@ -278,28 +388,17 @@ bool fpga_not_init (void) {
 	return 0;
 }
 
-#endif
-
 bool fpga_is_init (void) {
 	return fpga_init_flag;
 }
 
+bool fpga_is_mock (void) {
+	return fpga_mock_flag;
+}
 
 
-/* ========== FPGA Verification ========== */
-
-#ifdef PC_BUILD
-
-void fpga_verify (uint8_t *const *const grid) {
-	printf ("\tPC Build FPGA Verify\n\n"
-			"\tSet Dimensions: %d x %d\n"
-			"\tSet Cell Count: %d\n\n",
-			dimx, dimy, dimx * dimy);
 
-	return;
-}
-
-#else
+/* ========== FPGA Verification ========== */
 
 void fpga_test_fill (uint8_t *const *const grid, const uint8_t &num) {
 	for (unsigned int y = 0 ; y < dimy ; y ++) {
@@ -423,24 +522,10 @@ void fpga_verify (uint8_t *const *const grid) {
 	return;
 }
 
-#endif
-
 
 
 /* ========== AVALON S1 Functions ========== */
 
-#ifdef PC_BUILD
-
-void fpga_set_input (const uint64_t &write_data) {
-	return;
-}
-
-uint64_t fpga_get_output (void) {
-	return 0;
-}
-
-#else
-
 void fpga_set_input (const uint64_t &write_data) {
 	// FPGA Uninitialized Error Catch
 	if ( fpga_not_init () ) return;
@@ -488,33 +573,23 @@ uint64_t fpga_get_output (void) {
 	return results;
 }
 
-#endif
 
 
 
 /* ========== AVALON S2 Functions ========== */
 
-#ifdef PC_BUILD
-
-void fpga_clear (void) {
-	return;
-}
-
-void fpga_set_grid (const uint8_t *const *const grid) {
-	return;
-}
-
-#else
-
 void fpga_clear (void) {
 	// FPGA Uninitialized Error Catch
 	if ( fpga_not_init () ) return;
 
-	// Iterates over entire CA grid & sets to zero
+	// Iterates over entire CA grid & sets to zero -- Words already zero are skipped
 	for (uint32_t i = 0 ; i < SRAM_RANGE ; i++) {
-		fpga_s2_write (i, 0x0);
+		fpga_s2_update (i, 0x0);
 	}
 
+	// Every word has now been written at least once
+	s2_shadow_valid = 1;
+
 	// Sets input to zero
 	fpga_set_input (0x0);
 
@@ -522,82 +597,92 @@ void fpga_clear (void) {
 	fpga_wind_clock (2);
 }
 
-void fpga_set_grid (const uint8_t *const *const grid) {
+void fpga_load_image (const uint32_t *const image) {
 	// FPGA Uninitialized Error Catch
 	if ( fpga_not_init () ) return;
 
-	uint32_t data_buffer = 0;
-	uint32_t offset = SRAM_RANGE;
-
-	// Iterates through every row, from bottom to top -- loopvar must be signed
-	for (int y = dimy - 1 ; y >= 0 ; y--) {
-		// Iterates through every column, from right to left -- loopvar must be signed
-		for (int x = dimx - 1 ; x >= 0 ; x--) {
-			/* How this works:
-				Shift bits first, so the LSB would not get displaced.
-				0. [XXXX XXXX XXXX XXXX] << Start
-				1. [XXXX XXXX XXXX 0000] << Bitshift (to the left)
-				2. [XXXX XXXX XXXX CA00] << Set Cell
-				3. [XXXX XXXX CA00 0000] << Bitshift (to the left)
-				4. [XXXX XXXX CA00 CA01] << Set Cell
-				5. Repeat Until Buffer Filled
-				6. [CA00 CA01 CA02 CA03] << Set this to S2 @ Offset
-				7. Repeat for entire grid
-			*/
-
-			// Shifts one cell worth of data
-			data_buffer <<= CELL_DATA_WIDTH;
-			// Sets one cell worth of data
-			data_buffer |= grid [y][x];
-
-			// Every 32 bits filled to buffer, write to S2 port
-			if (x % CELL_IN_BUFFER == 0) {
-				/* Cycles through offset, from 511 to 0
-					Writes from bottom to top, to reduce waiting time
-				*/
-				offset--;
-				// Writes current buffer to offset
-				fpga_s2_write (offset, data_buffer);
-			}
-		}
+	// Writes from bottom to top, to reduce waiting time -- Only the changed words
+	for (int i = SRAM_RANGE - 1 ; i >= 0 ; i--) {
+		fpga_s2_update (i, image [i]);
 	}
 
+	// Every word has now been written at least once
+	s2_shadow_valid = 1;
 }
 
-#endif
+void fpga_set_grid (const uint8_t *const *const grid) {
+	uint32_t image [SRAM_RANGE];
 
+	ca_pack_grid (grid, image);
+	fpga_load_image (image);
+}
 
 
-/* ========== AVALON S3 Functions ========== */
 
-#ifdef PC_BUILD
+/* ========== AVALON S3 Functions ========== */
 
 void fpga_wind_clock (const uint16_t &cycles) {
-	return;
-}
+	fpga_s3_write (cycles);
 
-#else
+	const uint64_t start = fpga_now ();
 
-void fpga_wind_clock (const uint16_t &cycles) {
-	fpga_s3_write (cycles);
+	// Time the Cell Array needs to finish running, in microseconds
+	const uint32_t usec = 1 + (cycles / CYCLES_PER_USEC);
 
-	// Wait for the Cell Array to finish running
-	usleep ( 1 + (cycles / CYCLES_PER_USEC) );
-}
+	switch (wait_mode) {
+		case WAIT_SPIN:
+			fpga_spin (usec * spin_per_usec);
+			break;
 
-#endif
+		case WAIT_POLL:
+			// Gives up after the full run time -- FPGA configurations without the S3 status register
+			while ( fpga_s3_read () != 0 ) {
+				if ( fpga_now () - start > usec * 1000ULL ) {
+					idle.timeouts++;
+					break;
+				}
+			}
+			break;
 
+		default:
+			usleep (usec);
+			break;
+	}
 
+	// The mock device is not timed like the FPGA -- Always waits until it signals it is done
+	if (fpga_mock_flag) mock_wait ();
 
-/* ========== Version ROM Functions ========== */
+	idle.idle += fpga_now () - start;
+	idle.waits++;
+}
 
-#ifdef PC_BUILD
+uint16_t fpga_settle (const uint16_t &limit) {
+	// No access to the register state -- Runs the full limit
+	fpga_wind_clock (limit);
+	return 0;
+}
 
-void fpga_config_version (void) {
-	printf ("\tPC BUILD\n");
+void fpga_idle_reset (void) {
+	idle.start = fpga_now ();
+	idle.idle = 0;
+	idle.waits = 0;
+	idle.timeouts = 0;
 }
 
-#else
+void fpga_idle_report (void) {
+	const double total = (fpga_now () - idle.start) * 1e-9;
+	const double waited = idle.idle * 1e-9;
+	const char *const mode [3] = {"Sleep", "Spin", "Poll"};
+
+	printf ("\tWind-up Clock Wait (%s): %u waits | %.2f us per wait | %u poll timeouts\n"
+		"\tIdle %.3f s / %.3f s | %5.2f%%\n",
+		mode [wait_mode], idle.waits, (idle.waits > 0) ? (waited * 1e6 / idle.waits) : 0.0,
+		idle.timeouts, waited, total, (total > 0) ? (100 * waited / total) : 0.0 );
+}
+
+
+
+/* ========== Version ROM Functions ========== */
 
 void fpga_config_version (void) {
 	unsigned char ver_num [VROM_RANGE];
@@ -606,5 +691,3 @@ void fpga_config_version (void) {
 	}
 	printf ("\tFPGA Configuration <%s>\n", ver_num);
 }
-
-#endif
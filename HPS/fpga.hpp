@@ -8,6 +8,36 @@
 
 
 
+/* ========== Avalon Slave Ports ==========
+	The Cell Array module contains these Avalon Slave Ports.
+	Port 1 -- Linux IO
+	Port 2 -- RAM
+	Port 3 -- Clock Control
+
+	Byte offsets from the Lightweight HPS-to-FPGA bridge.
+	The mock device (mock.hpp) uses the same offsets.
+*/
+
+// --- S1 | Linux In / Out --- //
+#define S_IO		0x1000
+#define SIO_RANGE 2
+
+// --- S2 | Cell RAM --- //
+#define S_RAM		0x2000
+#define SRAM_RANGE 512
+
+// --- S3 | Wind-up Clock --- //
+#define S_CLK		0x0000
+
+/* --- Version ROM ---
+	This ROM module is used to keep track of what the FPGA configuration is.
+	Each FPGA config build will have a unique version number, embedded at compile time.
+*/
+#define VROM_ADDR		0x10000
+#define VROM_RANGE 16
+
+
+
 /* ========== Primitive Avalon Port Read / Write Functions ==========
 	Low level read / write functions. Static.
 	Limited to usage by other FPGA functions only.
@@ -41,6 +71,10 @@
 	Write 32-bit unsigned int to selected address offset of the RAM module
 */
 
+/* uint16_t fpga_s3_read (void)
+	Reads the remaining clock count of the windup_clock module -- Zero once it has finished
+*/
+
 /* void fpga_s3_write (const uint16_t &data)
 	Write 16-bit unsigned int to the windup_clock module
 */
@@ -55,6 +89,8 @@
 
 /* void fpga_init (void)
 	Initialize FPGA address pointers and variables.
+	Maps /dev/mem, or the mock device on the PC build, or if the Mock backend is selected.
+	Calling it again releases the previous mapping first.
 
 	Sets the flag 'fpga_init_flag' to 1, if successful.
 	Otherwise, set flag to 0.
@@ -86,6 +122,11 @@ void fpga_cleanup (void);
 */
 bool fpga_is_init (void);
 
+/* bool fpga_is_mock (void)
+	Returns 1 if the mock device (mock.hpp) is mapped, instead of the FPGA.
+*/
+bool fpga_is_mock (void);
+
 
 
 /* ========== FPGA Verification ========== */
@@ -155,21 +196,29 @@ uint64_t fpga_get_output (void);
 	Clears FPGA Cell Array, set all RAM to zero.
 	Set Cell Array input to zero
 
-	A special version of fpga_set_grid,
-	cycles through the entire S2 address range, and sets to zero.
+	Cycles through the entire S2 address range, and sets to zero.
+	Words already zero are skipped, see fpga_load_image().
 */
 void fpga_clear (void);
 
-/* void fpga_set_grid (const uint8_t *const *const grid)
-	Sets the FPGA Cell Array according to the given grid data.
-	Writes from the bottom-most row up, from LSB to MSB, offset 511 to 0.
+/* void fpga_load_image (const uint32_t *const image)
+	Sets the FPGA Cell Array RAM to a packed grid (global.hpp) -- Already the S2 format,
+	word 'i' of the image is written as is to offset 'i', from offset 511 to 0.
+	This ensures at most (PHYSICAL_DIMX * PHYSICAL_DIMY / 8) writes. (512)
 
-	Uses bitwise operations to set 4-bits at a time to the data buffer.
-	At every 8 cell (32-bits), write once to the given address offset,
-	then decrement the offset by one.
+	A shadow copy of the RAM is kept, fpga_clear() and fpga_load_image() only write the words
+	which differ from it. An image overwrites every word, so no clear is needed before it:
+	a child differs from the previous individual by a few rows, only those words are written.
 
-	Repeat this step over all rows and column.
-	This ensures precisely (MAX_CA_DIMX * MAX_CA_DIMY / 8) writes. (512)
+	Unlike fpga_clear(), the cell outputs are not reset, the new grid starts from the state
+	the previous grid left behind. The wait after each input flushes it from any loop-free cell,
+	so only such grids skip the clear, see Backend::replace().
+*/
+void fpga_load_image (const uint32_t *const image);
+
+/* void fpga_set_grid (const uint8_t *const *const grid)
+	Sets the FPGA Cell Array according to the given grid data.
+	Same as ca_pack_grid() followed by fpga_load_image().
 */
 void fpga_set_grid (const uint8_t *const *const grid);
 
@@ -180,9 +229,39 @@ void fpga_set_grid (const uint8_t *const *const grid);
 /* void fpga_wind_clock (const uint16_t &cycles)
 	Runs the specified number of clock cycles for the Cell Array.
 	Should fix the problem of unreliability and irreproducibility in timing.
+
+	Then waits for the Cell Array to finish, with the "EVAL Wait" strategy:
+		WAIT_SLEEP -- usleep() for the run time. Oversleeps by tens of microseconds on Linux.
+		WAIT_SPIN  -- Busy loop for the run time, calibrated by fpga_init().
+		WAIT_POLL  -- Reads the S3 status register until the remaining count reaches zero.
+		              Needs an FPGA configuration with the status register (windup_clock.v),
+		              gives up after the run time otherwise.
+	The mock device is always waited on until it is done, after the strategy has run.
+	It runs slower than the FPGA, so its polls often time out -- Only the FPGA's count matters.
 */
 void fpga_wind_clock (const uint16_t &cycles);
 
+/* uint16_t fpga_settle (const uint16_t &limit)
+	Runs the Cell Array until it settles, up to 'limit' clock cycles.
+	Returns the cycle length: 1 for a fixed point, more than 1 for an oscillating circuit,
+	or 0 if unknown.
+
+	The FPGA has no access to its register state -- Always runs the full 'limit' cycles,
+	and returns 0. Use the software backend (backend.hpp) to find the cycle length.
+*/
+uint16_t fpga_settle (const uint16_t &limit);
+
+/* void fpga_idle_reset (void)
+	Resets the wait instrumentation of fpga_wind_clock(). Done by fpga_init().
+*/
+void fpga_idle_reset (void);
+
+/* void fpga_idle_report (void)
+	Prints the time spent waiting for the wind-up clock since fpga_idle_reset(),
+	against the total time elapsed -- How much of the evaluation the HPS sat idle.
+*/
+void fpga_idle_report (void);
+
 
 
 /* ========== Version ROM Functions ========== */
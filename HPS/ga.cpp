@@ -6,10 +6,11 @@
 /* ========== Standard Library Include ========== */
 
 #include <stdio.h>		// Standard I/O
-#include <stdlib.h>		// calloc, free
+#include <stdlib.h>		// calloc, free, posix_memalign
+#include <string.h>		// memset, memcpy
 #include <stdint.h>		// uint definitions
-#include <math.h>		// floor
-#include <algorithm>	// sort
+#include <math.h>		// floor, log, log1p
+#include <algorithm>	// random_shuffle
 #include <iostream>		// cout
 
 
@@ -21,72 +22,223 @@
 #include "ca.hpp"
 #include "global.hpp"
 #include "fast.hpp"
+#include "memo.hpp"
 
 
 
 using namespace std;
 using namespace GlobalSettings;
 
-/* Max Probability int
-	Set this to some number large enough to express the probability range sufficiently.
-	Mutation probability 'mutp' is a float of range [0, 1.0]
-	mutp is multiplied with a random number, then modulo by this number.
-	A number too small could cause the program to become faulty.
-	But a number too large would be computationally expensive.
-
-	> This is probably unnecessary.
-	> Consider removing and directly comparing floats for propbability calcs.
+/* Mutation Mix -- Percent of all mutations, see Mutate()
+	Minor and swap mutations, scramble mutations take the rest.
 */
-#define P_MAX 100000
+#define MUT_MINOR 75
+#define MUT_SWAP 20
 
 // Global Object Counter for UID
 static uint32_t object_count = 0;
 
+// Population Arena Alignment (Bytes) -- One cache line
+#define ARENA_ALIGN 64
+
+/* Population Arena
+	The DNA and CA grid of every individual, in a single slab -- See arena_alloc().
+*/
+static uint8_t *arena = nullptr;
+static size_t arena_slot = 0;
+static unsigned int arena_size = 0;
+static unsigned int arena_next = 0;
+
+// Radix Sort Digit Width (Bits) -- Sort()
+#define RADIX_BITS 8
+#define RADIX_SIZE (1 << RADIX_BITS)
+
+// Key digits, the lowest 2 digits are the array index -- See rank_key()
+#define RADIX_DIGITS (64 / RADIX_BITS)
+#define RADIX_SKIP (16 / RADIX_BITS)
+
+/* Rank Permutation
+	rank_index [r] is the array index of rank 'r'. Allocated with the arena.
+	sort_key and sort_swap are the key buffers of Sort().
+*/
+static uint32_t *rank_index = nullptr;
+static uint64_t *sort_key = nullptr;
+static uint64_t *sort_swap = nullptr;
+
 
 static uint32_t live_count;
 static uint32_t dead_count;
 
+/* Mutation Plan -- Worked out once per generation, see mutate_plan()
+	The gap between two mutated genes is geometric: floor (log (U) / log (1 - MUTP)), U uniform in (0, 1]
+*/
+struct ga_mutate {
+	// Any gene mutates at all -- MUTP > 0
+	bool any;
+	// 1 / log (1 - MUTP) -- Zero if every gene mutates, MUTP = 1
+	double scale;
+};
+
+/* Repopulate() Job -- See Breed()
+	Shared by every breeding thread. Only the offspring, and their fates, are written to.
+*/
+struct ga_pick {
+	uint32_t fit;
+	uint32_t age;
+	uint16_t index;
+};
+
+struct ga_breed {
+	GeneticAlgorithm *array;
+	const uint8_t *seed;
+
+	// Snapshot of the live individuals by rank, and the dead ones to replace
+	const ga_pick *live;
+	unsigned int live_count;
+	const uint16_t *dead;
+
+	// PRNG stream, and fate, of each offspring -- Offspring 'j' replaces dead [j]
+	const Xoshiro128ss *stream;
+	uint8_t *fate;
+	unsigned int count;
+
+	ga_mutate mutate;
+
+	// Called with every offspring as soon as its circuit is generated, if given -- See Repopulate()
+	void (*ready) (const unsigned int &index);
+};
+
+// What became of an offspring -- See Breed()
+#define FATE_NEUTRAL 0	// Inherited a parent's circuit and scores
+#define FATE_CACHED 1	// Scores found in the fitness cache
+#define FATE_REGEN 2	// Circuit regenerated from a parent's
+#define FATE_BATCH 3	// Whole circuit generated by ca_gen_batch()
+
+/* static ptrdiff_t shuffle_rng (ptrdiff_t n)
+	Random number in [0, n) for std::random_shuffle(), from the calling thread's stream.
+	Unlike std::rand(), safe to call from several threads, and the same on any of them.
+*/
+static ptrdiff_t shuffle_rng (ptrdiff_t n) {
+	return fast_rng32 (n);
+}
 
-// =====================================================
-// GENETIC ALGORITHM CLASS METHODS
-// =====================================================
+/* static ga_mutate mutate_plan (const float &mutp)
+	Mutation plan of Mutate(), for a mutation probability of 'mutp' per gene.
+*/
+static ga_mutate mutate_plan (const float &mutp) {
+	ga_mutate plan;
+	plan.any = (mutp > 0);
+	plan.scale = (mutp < 1) ? 1.0 / log1p (-mutp) : 0.0;
+	return plan;
+}
 
-/* ========== Compare Functions ========== */
+/* static uint32_t mutate_gap (const ga_mutate &plan, const uint32_t &limit)
+	Number of genes to skip before the next mutated one, capped at 'limit'.
+	A single random number per mutated gene, none at all if every gene mutates.
+*/
+static uint32_t mutate_gap (const ga_mutate &plan, const uint32_t &limit) {
+	if (plan.scale == 0) return 0;
 
-bool GeneticAlgorithm::compfit_descend (const GeneticAlgorithm &a, const GeneticAlgorithm &b) {
-	// If A is a solution, and B is not a solution,
-	// A goes before B is True
-	if ((a.sol == 1) && (b.sol == 0)) return 1;
+	// U in (0, 1] -- Never log (0)
+	const double u = (fast_rng32 () + 1.0) * (1.0 / 4294967296.0);
+	const double gap = floor (log (u) * plan.scale);
 
-	// If B is a solution, and A is not a solution,
-	// A goes before B is False
-	if ((a.sol == 0) && (b.sol == 1)) return 0;
+	return (gap < limit) ? (uint32_t) gap : limit;
+}
+
+/* static uint64_t cross_mask (const uint32_t &bits)
+	Byte mask of 8 genes from the low 8 bits of 'bits', bit 'k' set gives 0xFF in byte 'k'.
+	Spreads bit 'k' to the top of byte 'k', then fills each byte below its top bit.
+*/
+static uint64_t cross_mask (const uint32_t &bits) {
+	uint64_t mask = ((bits & 0xFF) * 0x0101010101010101ULL) & 0x8040201008040201ULL;
+	mask = ((mask + 0x7F7F7F7F7F7F7F7FULL) & 0x8080808080808080ULL) >> 7;
+	return mask * 0xFF;
+}
 
-	// Compare by fitness, fitter goes first
-	// For A goes before B:
-	if (a.fit > b.fit) return 1;
-	if (a.fit < b.fit) return 0;
+/* static uint32_t list_differ (const uint8_t *const dna_a, const uint8_t *const dna_b,
+	const uint32_t &dna_length, uint32_t *const differ)
 
-	// Compare gate efficiency, higher gate efficiency goes first
-	return (a.gate >= b.gate);
+	Writes the index of every gene where 'dna_a' and 'dna_b' differ to 'differ', in order.
+	Compares 8 genes at a time. Returns the number of genes listed.
+*/
+static uint32_t list_differ (const uint8_t *const dna_a, const uint8_t *const dna_b,
+const uint32_t &dna_length, uint32_t *const differ) {
+	uint32_t count = 0;
+	uint32_t i = 0;
+
+	for ( ; i + 8 <= dna_length ; i += 8) {
+		uint64_t a, b;
+		memcpy (&a, dna_a + i, 8);
+		memcpy (&b, dna_b + i, 8);
+
+		// Nonzero bytes of the difference, lowest first
+		uint64_t diff = a ^ b;
+
+		while (diff) {
+			const uint32_t k = __builtin_ctzll (diff) / 8;
+			differ [count] = i + k;
+			count++;
+			diff &= ~(0xFFULL << (8 * k));
+		}
+	}
+
+	for ( ; i < dna_length ; i++) {
+		if (dna_a [i] != dna_b [i]) {
+			differ [count] = i;
+			count++;
+		}
+	}
+
+	return count;
 }
 
-bool GeneticAlgorithm::compfit_ascend (const GeneticAlgorithm &a, const GeneticAlgorithm &b) {
-	// If A is a solution, and B is not a solution,
-	// A goes before B is False
-	if ((a.sol == 1) && (b.sol == 0)) return 0;
+/* static uint32_t merge_genes (const uint32_t *const list_a, const uint32_t &count_a,
+	const uint32_t *const list_b, const uint32_t &count_b, uint32_t *const out)
 
-	// If B is a solution, and A is not a solution,
-	// A goes before B is True
-	if ((a.sol == 0) && (b.sol == 1)) return 1;
+	Merges two ordered lists of gene indices into 'out', in order and only once.
+	Returns the number of genes in 'out'.
+*/
+static uint32_t merge_genes (const uint32_t *const list_a, const uint32_t &count_a,
+const uint32_t *const list_b, const uint32_t &count_b, uint32_t *const out) {
+	uint32_t a = 0, b = 0, count = 0;
+
+	while (a < count_a || b < count_b) {
+		if (b == count_b || (a < count_a && list_a [a] < list_b [b])) {
+			out [count] = list_a [a];
+			a++;
+		} else if (a == count_a || list_b [b] < list_a [a]) {
+			out [count] = list_b [b];
+			b++;
+		} else {
+			out [count] = list_a [a];
+			a++;
+			b++;
+		}
 
-	// Compare by fitness
-	// For A goes before B:
-	if (a.fit > b.fit) return 0;
-	if (a.fit < b.fit) return 1;
+		count++;
+	}
 
-	// Compare gate efficiency, lower gate efficiency goes first
-	return (a.gate <= b.gate);
+	return count;
+}
+
+// Offspring bred, and those which inherited a parent's circuit -- See Inherit()
+static uint32_t birth_count = 0;
+static uint32_t neutral_count = 0;
+
+
+// =====================================================
+// GENETIC ALGORITHM CLASS METHODS
+// =====================================================
+
+/* ========== Compare Functions ========== */
+
+uint64_t GeneticAlgorithm::rank_key (const GeneticAlgorithm &a, const uint32_t &index) {
+	// Solutions first, then fitter, then higher gate efficiency -- See rank_key() in ga.hpp
+	return ((uint64_t) a.sol << 63)
+		| ((uint64_t) (a.fit & 0x7FFFFFFF) << 32)
+		| ((uint64_t) a.gate << 16)
+		| (index & 0xFFFF);
 }
 
 
@@ -97,7 +249,10 @@ GeneticAlgorithm::GeneticAlgorithm (void) {
 	uid = object_count;
 	object_count++;
 	dna = nullptr;
-	grid = nullptr;
+	image = nullptr;
+	first = nullptr;
+	usage = nullptr;
+	trace = nullptr;
 	fit = 0;
 	gate = 0;
 	age = 0;
@@ -110,10 +265,26 @@ GeneticAlgorithm::GeneticAlgorithm (const uint32_t &dna_length) {
 	uid = object_count;
 	object_count++;
 
-	dna = GeneticAlgorithm::dna_calloc (dna_length);
-	GeneticAlgorithm::dna_rand_fill (dna, dna_length);
+	// Takes the next slot of the arena -- CA grid first, it is the aligned one
+	if (arena_next < arena_size) {
+		uint8_t *const slot = arena + (arena_next * arena_slot);
+		arena_next++;
+
+		image = (uint32_t *) slot;
+		first = image + PACKED_SIZE;
+		usage = (uint64_t *) (first + PACKED_SIZE);
+		trace = (uint8_t *) (usage + CA_USAGE_WORDS (dna_length));
+		dna = trace + dna_length;
+	} else {
+		printf (ANSI_RED "\nERROR: POPULATION ARENA FULL\n" ANSI_RESET);
+		image = nullptr;
+		first = nullptr;
+		usage = nullptr;
+		trace = nullptr;
+		dna = nullptr;
+	}
 
-	grid = GeneticAlgorithm::grid_calloc ();
+	GeneticAlgorithm::dna_rand_fill (dna, dna_length);
 	// Doesn't generate grid here - Done in Repopulate()
 
 	fit = 0;
@@ -124,13 +295,57 @@ GeneticAlgorithm::GeneticAlgorithm (const uint32_t &dna_length) {
 	sol = 0;
 }
 
-void GeneticAlgorithm::Free (void) {
-	free (this->dna);
 
-	for (uint16_t y = 0 ; y < PHYSICAL_DIMY ; y++) {
-		free (this->grid[y]);
+
+/* ========== Population Arena ========== */
+
+bool GeneticAlgorithm::arena_alloc (const unsigned int &pop, const uint32_t &dna_length) {
+	arena_free ();
+
+	// Rounds each slot up to the alignment, so every slot starts aligned
+	const size_t size = 2 * PACKED_SIZE * sizeof (uint32_t)
+		+ CA_USAGE_WORDS (dna_length) * sizeof (uint64_t) + 2 * dna_length;
+	arena_slot = (size + ARENA_ALIGN - 1) / ARENA_ALIGN * ARENA_ALIGN;
+
+	void *slab = nullptr;
+	if ( posix_memalign (&slab, ARENA_ALIGN, arena_slot * pop) != 0 ) {
+		printf (ANSI_RED "\nERROR: POPULATION ARENA ALLOC FAILED\n" ANSI_RESET);
+		return 0;
 	}
-	free (this->grid);
+
+	memset (slab, 0, arena_slot * pop);
+
+	arena = (uint8_t *) slab;
+	arena_size = pop;
+	arena_next = 0;
+
+	birth_count = 0;
+	neutral_count = 0;
+
+	// Rank permutation -- Array order until the first Sort()
+	rank_index = (uint32_t *) calloc (pop, sizeof (uint32_t));
+	sort_key = (uint64_t *) calloc (pop, sizeof (uint64_t));
+	sort_swap = (uint64_t *) calloc (pop, sizeof (uint64_t));
+
+	for (unsigned int i = 0 ; i < pop ; i++) {
+		rank_index [i] = i;
+	}
+
+	return 1;
+}
+
+void GeneticAlgorithm::arena_free (void) {
+	free (arena);
+	free (rank_index);
+	free (sort_key);
+	free (sort_swap);
+
+	arena = nullptr;
+	rank_index = nullptr;
+	sort_key = nullptr;
+	sort_swap = nullptr;
+	arena_size = 0;
+	arena_next = 0;
 }
 
 
@@ -142,7 +357,7 @@ void GeneticAlgorithm::Selection (GeneticAlgorithm *const array) {
 
 	/* 	========== Natural Selection ==========
 		Selection is done by ranking and age.
-		It is required that the population be sorted by fitness before selection.
+		It is required that the population be ranked by fitness (Sort()) before selection.
 
 		>> Rank-proportional Survivability
 		The higher the rank of an individual, the higher chance of survival.
@@ -162,7 +377,7 @@ void GeneticAlgorithm::Selection (GeneticAlgorithm *const array) {
 		This is still relatively unlikely, but a possibility to keep in mind.
 
 		NOTE:
-		The array index is equivalent to the rank, because the array is pre-sorted.
+		The array is not reordered by Sort(), the rank permutation maps each rank to its array index.
 		We will be keeping track of the index,
 		because it allows easy access to the original population and its properties, via array[i].
 	*/
@@ -171,9 +386,11 @@ void GeneticAlgorithm::Selection (GeneticAlgorithm *const array) {
 	dead_count = 0;
 
 	for (unsigned int rank = 0 ; rank < pop ; rank++) {
+		const uint32_t i = rank_index [rank];
+
 		// Leak catch -- 'Live' individuals will have status of being 'dead'
 		// Usually a sign of bad memory management elsewhere.
-		if ( array[rank].alive == 0 ) {
+		if ( array[i].alive == 0 ) {
 			dead_count++;
 			printf (ANSI_RED "\tWalking Dead!!!\n" ANSI_RESET);
 			continue;
@@ -189,7 +406,7 @@ void GeneticAlgorithm::Selection (GeneticAlgorithm *const array) {
 			the likelihood of death decreases p(RNG < smaller number) < p(RNG < larger number).
 		*/
 		if ( rng < rank ) {
-			array [rank].alive = 0;
+			array [i].alive = 0;
 			dead_count++;
 		} else {
 			live_count++;
@@ -204,20 +421,19 @@ void GeneticAlgorithm::Selection (GeneticAlgorithm *const array) {
 	return;
 }
 
-void GeneticAlgorithm::Repopulate (GeneticAlgorithm *const array, const uint8_t *const seed) {
+void GeneticAlgorithm::Repopulate (GeneticAlgorithm *const array, const uint8_t *const seed,
+void (*ready) (const unsigned int &index), ga_run *const run) {
 	uint16_t live [live_count] = {0};
 	uint16_t dead [dead_count] = {0};
 
 	// Gets the variable values once -- per individual
 	const unsigned int pop = get_ga_pop ();
-	const unsigned int pool = get_ga_pool ();
-	const unsigned int dna_length = get_dna_length();
-	const float mutp = get_ga_mutp ();
-	const unsigned int color = get_ca_color ();
 
-	// Puts the array index of alive / dead individuals into their respective groups
+	// Puts the array index of alive / dead individuals into their respective groups, by rank
 	int l = 0, d = 0;
-	for (unsigned int i = 0 ; i < pop ; i++) {
+	for (unsigned int rank = 0 ; rank < pop ; rank++) {
+		const uint32_t i = rank_index [rank];
+
 		if ( array[i].alive == 1 ) {
 			live [l] = i;
 			l++;
@@ -227,14 +443,87 @@ void GeneticAlgorithm::Repopulate (GeneticAlgorithm *const array, const uint8_t
 		}
 	}
 
+	if (dead_count == 0) return;
+
+	// Snapshot of the live individuals, by rank -- The tournaments only read this
+	ga_pick pick [live_count];
+
+	for (unsigned int k = 0 ; k < live_count ; k++) {
+		pick [k].fit = array[live[k]].fit;
+		pick [k].age = array[live[k]].age;
+		pick [k].index = live [k];
+	}
+
+	/* Offspring Streams
+		Offspring 'j' is bred from stream 'j', (j+1) jumps ahead of this generation's base stream.
+		The base is the main thread's stream, which then long-jumps past every stream of the generation.
+	*/
+	Xoshiro128ss stream [dead_count];
+	Xoshiro128ss &master = rng32 ();
+	Xoshiro128ss base = master;
+	master.long_jump ();
+
+	for (unsigned int j = 0 ; j < dead_count ; j++) {
+		base.jump ();
+		stream [j] = base;
+	}
+
+	uint8_t fate [dead_count];
+
+	ga_breed job;
+	job.array = array;
+	job.seed = seed;
+	job.live = pick;
+	job.live_count = live_count;
+	job.dead = dead;
+	job.stream = stream;
+	job.fate = fate;
+	job.count = dead_count;
+	job.mutate = mutate_plan (get_ga_mutp ());
+	job.ready = ready;
+
+	// ========== BREEDING ========== //
+
+	// Every part on its own thread of 'run', or every offspring on this thread
+	if (run != NULL) {
+		run (breed_task, &job);
+	} else {
+		const Xoshiro128ss save = master;
+		Breed (job, 0, 1);
+		master = save;
+	}
+
+	for (unsigned int j = 0 ; j < dead_count ; j++) {
+		birth_count++;
+		if (fate [j] == FATE_NEUTRAL) neutral_count++;
+	}
+
+	return;
+}
+
+void GeneticAlgorithm::Breed (const ga_breed &job, const unsigned int &part, const unsigned int &parts) {
+	// Gets the variable values once -- per individual
+	const unsigned int pool = get_ga_pool ();
+	const unsigned int dna_length = get_dna_length();
+	const unsigned int color = get_ca_color ();
+	const unsigned int cross = get_ga_cross ();
 
+	GeneticAlgorithm *const array = job.array;
+	const ga_pick *const live = job.live;
 
-	// ========== TOURNAMENT SELECTION ========== //
+	// Offspring of this part whose whole circuit is generated, CA_BATCH at a time -- See ca_gen_batch()
+	uint16_t batch [CA_BATCH];
+	unsigned int batch_count = 0;
 
-	// Using counter d to count how many deads are left
-	for ( d = d-1 ; d >= 0 ; d--) {
+	for (unsigned int j = part ; j < job.count ; j += parts) {
+		// Same stream, same offspring -- On any thread
+		rng32 () = job.stream [j];
+
+		GeneticAlgorithm &child = array [ job.dead [j] ];
 		uint16_t parent [2];
 
+		// ========== TOURNAMENT SELECTION ========== //
+
 		/* Tournament Selection Pool
 			Iterates POOL number of times, per parent.
 			In each iteration, pick a random alive individual's index number to compare.
@@ -253,85 +542,240 @@ void GeneticAlgorithm::Repopulate (GeneticAlgorithm *const array, const uint8_t
 			If both parents happen to be the same individual (the individual won twice),
 			generate a random individual entirely.
 		*/
-		for (unsigned int j = 0 ; j < 2 ; j++) {
+		for (unsigned int p = 0 ; p < 2 ; p++) {
 			// pcur == Current Pick -- start with the weakest in the pool
 			// pnew == New Pick
-			uint16_t pcur = live [ live_count-1 ];
-			uint16_t pnew;
+			uint32_t pcur = job.live_count - 1;
+			uint32_t pnew;
 
 			// Tournament Pool Loop
 			for (unsigned int i = 0 ; i < pool ; i++) {
 				// Pick a random live individual
-				pnew = live [ fast_rng32 () % live_count ];
+				pnew = fast_rng32 () % job.live_count;
 
 				// Compare by fitness -- fittest wins
-				if ( array[pnew].fit > array[pcur].fit ) {
+				if ( live[pnew].fit > live[pcur].fit ) {
 					// New pick is fitter, Keep new pick
 					pcur = pnew;
 					continue;
 				}
 
 				// Compare by age -- youngest wins
-				if ( array[pnew].age < array[pcur].age ) {
+				if ( live[pnew].age < live[pcur].age ) {
 					// New pick is younger, Keep new pick
 					pcur = pnew;
 				}
 			}
 
 			// Assign current pick as parent
-			parent [j] = pcur;
+			parent [p] = live[pcur].index;
 		}
 
 		// Resets a dead individual
-		array[dead[d]].Reset ();
+		child.Reset ();
+
+		// Genes where the parents differ, and genes mutated -- In order, see grid_regen()
+		uint32_t differ [dna_length];
+		uint32_t mutated [dna_length];
+		uint32_t changed [dna_length];
+		uint32_t differ_count = 0;
 
 		// Confirms two different parents
 		if ( parent [0] != parent [1] ) {
 			// Reproduce Normally
-			array[dead[d]].Crossover
-			(array[parent[0]].dna, array[parent[1]].dna, dna_length);
+			differ_count = child.Crossover (array[parent[0]].dna, array[parent[1]].dna,
+				dna_length, cross, color, differ);
 		} else {
 			// If both picks are the same, generate new DNA randomly
-			array[dead[d]].dna_rand_fill (dna_length);
+			child.dna_rand_fill (dna_length);
 		}
 
 		// Mutate DNA
-		array[dead[d]].Mutate (mutp, color, dna_length);
+		const uint32_t mutated_count = child.Mutate (job.mutate, color, dna_length, mutated);
+		const uint32_t changed_count = merge_genes (differ, differ_count, mutated, mutated_count, changed);
 
-		// Generate new circuit
-		array[dead[d]].grid_gen (seed);
+		// Only genes unused by a parent's circuit changed -- Same circuit, same scores
+		if ( parent [0] != parent [1] ) {
+			if ( child.Inherit (array[parent[0]], dna_length) || child.Inherit (array[parent[1]], dna_length) ) {
+				job.fate [j] = FATE_NEUTRAL;
+				continue;
+			}
+		}
+
+		// Same DNA as one already evaluated -- Takes its scores, no circuit needed (memo.hpp)
+		if ( memo_find (child.dna, dna_length, child.fit, child.gate, child.sol) ) {
+			memset (child.usage, 0, CA_USAGE_WORDS (dna_length) * sizeof (uint64_t));
+			child.eval = 1;
+			job.fate [j] = FATE_CACHED;
+			continue;
+		}
+
+		// Generate new circuit -- Only the rows differing from a parent's, if possible
+		if ( parent [0] != parent [1] &&
+		child.grid_regen (job.seed, array[parent[0]], array[parent[1]], dna_length, changed, changed_count) ) {
+			job.fate [j] = FATE_REGEN;
+
+			// Hands the offspring over, e.g. for evaluation
+			if (job.ready != NULL) job.ready (job.dead [j]);
+			continue;
+		}
+
+		job.fate [j] = FATE_BATCH;
+		batch [batch_count] = job.dead [j];
+		batch_count++;
+
+		if (batch_count == CA_BATCH) {
+			breed_batch (job, batch, batch_count);
+			batch_count = 0;
+		}
 	}
 
-	return;
+	// The rest of the whole circuits
+	if (batch_count > 0) breed_batch (job, batch, batch_count);
+}
+
+void GeneticAlgorithm::breed_batch (const ga_breed &job, const uint16_t *const batch, const unsigned int &count) {
+	GeneticAlgorithm *const array = job.array;
+	ca_image out [CA_BATCH];
+	const uint8_t *dna [CA_BATCH];
+
+	for (unsigned int k = 0 ; k < count ; k++) {
+		out [k] = array[batch[k]].circuit ();
+		dna [k] = array[batch[k]].dna;
+	}
+
+	ca_gen_batch (out, dna, count, job.seed);
+
+	// Hands the offspring over, as soon as their circuits are generated
+	if (job.ready != NULL) {
+		for (unsigned int k = 0 ; k < count ; k++) job.ready (batch [k]);
+	}
 }
 
-void GeneticAlgorithm::Crossover
-(const uint8_t *const dna_a, const uint8_t *const dna_b, const unsigned int &dna_length) {
-	// Determine which gene comes from which parent -- 50-50 chance for any given gene
-	for (uint16_t i = 0 ; i < dna_length ; i++) {
-		if ( (fast_rng32 () % 1) )
-			this->dna [i] = dna_a [i];
-		else
-			this->dna [i] = dna_b [i];
+void GeneticAlgorithm::breed_task (void *const arg, const unsigned int &part, const unsigned int &parts) {
+	Breed (*(const ga_breed *) arg, part, parts);
+}
+
+uint32_t GeneticAlgorithm::Crossover (const uint8_t *const dna_a, const uint8_t *const dna_b,
+const unsigned int &dna_length, const unsigned int &mode, const unsigned int &color, uint32_t *const differ) {
+	switch (mode) {
+		case CROSS_ONE_POINT: {
+			// Cut in [1, dna_length - 1] -- Never a copy of a single parent
+			const uint32_t cut = 1 + fast_rng32 () % (dna_length - 1);
+			memcpy (this->dna, dna_a, cut);
+			memcpy (this->dna + cut, dna_b + cut, dna_length - cut);
+			break;
+		}
+
+		case CROSS_TWO_POINT: {
+			uint32_t cut [2] = { fast_rng32 () % (dna_length + 1), fast_rng32 () % (dna_length + 1) };
+			if (cut [0] > cut [1]) std::swap (cut [0], cut [1]);
+
+			memcpy (this->dna, dna_a, dna_length);
+			memcpy (this->dna + cut [0], dna_b + cut [0], cut [1] - cut [0]);
+			break;
+		}
+
+		case CROSS_RULE_BLOCK: {
+			// Rules sharing the most significant neighbor are contiguous -- See ca_gen_row()
+			const uint32_t block = dna_length / color;
+			uint32_t bits = 0;
+
+			for (uint32_t b = 0 ; b < color ; b++) {
+				if (b % 32 == 0) bits = fast_rng32 ();
+				const uint8_t *const src = ((bits >> (b % 32)) & 1) ? dna_a : dna_b;
+				memcpy (this->dna + b * block, src + b * block, block);
+			}
+			break;
+		}
+
+		default: {
+			/* Uniform -- 50-50 chance for any given gene
+				One random word decides 32 genes, blended 8 at a time: child = (a & mask) | (b & ~mask)
+			*/
+			uint32_t bits = 0;
+			uint32_t i = 0;
+
+			for ( ; i + 8 <= dna_length ; i += 8) {
+				if (i % 32 == 0) bits = fast_rng32 ();
+
+				uint64_t a, b;
+				memcpy (&a, dna_a + i, 8);
+				memcpy (&b, dna_b + i, 8);
+
+				const uint64_t mask = cross_mask (bits >> (i % 32));
+				a = (a & mask) | (b & ~mask);
+				memcpy (this->dna + i, &a, 8);
+			}
+
+			// Last few genes, one at a time
+			if (i < dna_length) {
+				if (i % 32 == 0) bits = fast_rng32 ();
+				bits >>= i % 32;
+
+				for ( ; i < dna_length ; i++, bits >>= 1) {
+					this->dna [i] = (bits & 1) ? dna_a [i] : dna_b [i];
+				}
+			}
+			break;
+		}
 	}
 
-	return;
+	// The only genes where the offspring can differ from either parent
+	if (differ == NULL) return 0;
+	return list_differ (dna_a, dna_b, dna_length, differ);
 }
 
-void GeneticAlgorithm::Mutate
-(const float &mutp, const unsigned int &color, const unsigned int &dna_length) {
-	// Iterates over each DNA
-	for (uint32_t i = 0 ; i < dna_length ; i++) {
-		uint16_t rng = fast_rng32 () % P_MAX;
+bool GeneticAlgorithm::Inherit (const GeneticAlgorithm &parent, const uint32_t &dna_length) {
+	const uint32_t words = CA_USAGE_WORDS (dna_length);
+	uint64_t any = 0;
 
-		// Do Nothing | 1 - MUTP probability
-		if (rng > floor (mutp * P_MAX) ) {
-			continue;
+	// Every used gene must match
+	for (uint32_t w = 0 ; w < words ; w++) {
+		uint64_t used = parent.usage [w];
+		any |= used;
+
+		while (used) {
+			const uint32_t i = w * 64 + __builtin_ctzll (used);
+			if ( this->dna [i] != parent.dna [i] ) return 0;
+			used &= used - 1;
 		}
+	}
+
+	// Parent's circuit was never generated
+	if (any == 0) return 0;
+
+	memcpy (this->image, parent.image, PACKED_SIZE * sizeof (uint32_t));
+	memcpy (this->first, parent.first, PACKED_SIZE * sizeof (uint32_t));
+	memcpy (this->usage, parent.usage, words * sizeof (uint64_t));
+	memcpy (this->trace, parent.trace, dna_length);
+
+	this->fit = parent.fit;
+	this->gate = parent.gate;
+	this->sol = parent.sol;
+	this->eval = 1;
+
+	return 1;
+}
+
+uint32_t GeneticAlgorithm::Mutate (const ga_mutate &plan, const unsigned int &color,
+const unsigned int &dna_length, uint32_t *const changed) {
+	if (plan.any == 0) return 0;
+
+	// Genes changed so far -- Same layout as the rule-usage bitmap (ca.hpp)
+	const uint32_t words = CA_USAGE_WORDS (dna_length);
+	uint64_t touched [words];
+	memset (touched, 0, words * sizeof (uint64_t));
+
+	// Jumps from one mutated gene to the next
+	for (uint32_t i = mutate_gap (plan, dna_length) ; i < dna_length ; i += 1 + mutate_gap (plan, dna_length)) {
+		const uint32_t kind = fast_rng32 (100);
 
 		// Minor Mutations | 75% of all mutations
-		if (rng > floor (mutp * P_MAX * 0.25) ) {
-			switch (rng % 5) {
+		if (kind < MUT_MINOR) {
+			const uint8_t prev = this->dna [i];
+
+			switch (fast_rng32 (5)) {
 				case 0:
 					this->dna [i] = 0;
 					break;
@@ -339,7 +783,7 @@ void GeneticAlgorithm::Mutate
 					this->dna [i] = color - 1;
 					break;
 				case 2:
-					this->dna [i] = fast_rng32 () % color;
+					this->dna [i] = fast_rng32 (color);
 					break;
 				case 3:
 					if (this->dna [i] > 0) {
@@ -352,32 +796,57 @@ void GeneticAlgorithm::Mutate
 					}
 					break;
 			}
+
+			if (this->dna [i] != prev) touched [i / 64] |= 1ULL << (i % 64);
 			continue;
 		}
 
 		// Swap Mutation | 20% of all mutations
-		if (rng > floor (mutp * P_MAX * 0.05) ) {
-			uint16_t dest = fast_rng32 () % dna_length;
-			uint8_t tmp = this->dna [i];
-			this->dna [i] = this->dna [dest];
-			this->dna [dest] = tmp;
+		if (kind < MUT_MINOR + MUT_SWAP) {
+			const uint32_t dest = fast_rng32 (dna_length);
+
+			if (this->dna [i] != this->dna [dest]) {
+				uint8_t tmp = this->dna [i];
+				this->dna [i] = this->dna [dest];
+				this->dna [dest] = tmp;
+
+				touched [i / 64] |= 1ULL << (i % 64);
+				touched [dest / 64] |= 1ULL << (dest % 64);
+			}
 			continue;
 		}
 
 		/* Scramble (Least Likely) | 5%  of all mutation
 			Picks two anchor points,
 			The first is the current DNA index (i)
-			The second is a random point within the DNA string (fast_rng32 () % dna_length)
+			The second is a random point within the DNA string
+			Shuffles the genes between them, the larger anchor excluded.
 		*/
-		uint16_t anchor = fast_rng32 () % dna_length;
-		if (i > anchor) {
-			random_shuffle (&dna [anchor], &dna [i]);
-		} else if (anchor > i) {
-			random_shuffle (&dna [i], &dna [anchor]);
+		const uint32_t anchor = fast_rng32 (dna_length);
+		const uint32_t begin = (i < anchor) ? i : anchor;
+		const uint32_t end = (i < anchor) ? anchor : i;
+
+		random_shuffle (&dna [begin], &dna [end], shuffle_rng);
+
+		for (uint32_t k = begin ; k < end ; k++) {
+			touched [k / 64] |= 1ULL << (k % 64);
 		}
 	}
 
-	return;
+	// Lists the changed genes, in order
+	uint32_t count = 0;
+
+	for (uint32_t w = 0 ; w < words ; w++) {
+		uint64_t bits = touched [w];
+
+		while (bits) {
+			if (changed != NULL) changed [count] = w * 64 + __builtin_ctzll (bits);
+			count++;
+			bits &= bits - 1;
+		}
+	}
+
+	return count;
 }
 
 
@@ -393,18 +862,6 @@ void GeneticAlgorithm::Reset (void) {
 	this -> sol = 0;
 }
 
-uint8_t *GeneticAlgorithm::dna_calloc (const uint32_t &dna_length) {
-	// Allocates memory for DNA string
-	uint8_t *dna = (uint8_t *) calloc (dna_length, sizeof (uint8_t));
-
-	// If Memory Allocation Failed
-	if (dna == nullptr) {
-		printf (ANSI_RED "\nERROR: DNA CALLOC FAILED\n" ANSI_RESET);
-	}
-
-	return dna;
-}
-
 void GeneticAlgorithm::dna_rand_fill (const uint32_t &dna_length) {
 	// Checks if DNA is NULL
 	if (this -> dna == NULL) {
@@ -437,34 +894,133 @@ void GeneticAlgorithm::dna_rand_fill (uint8_t *const dna, const uint32_t &dna_le
 	return;
 }
 
-uint8_t **GeneticAlgorithm::grid_calloc (void) {
-	// Allocates memory for each cell's circuits
-	uint8_t **grid = (uint8_t **) calloc (PHYSICAL_DIMY, sizeof (uint8_t *));
-	for (uint16_t y = 0 ; y < PHYSICAL_DIMY ; y++) {
-		grid [y] = (uint8_t *) calloc (PHYSICAL_DIMX, sizeof (uint8_t));
-	}
+void GeneticAlgorithm::grid_gen (const uint8_t *const seed) {
+	// Generates twice,
+	// This effectively generates a (DIMX,2*DIMY) grid from seed.
+	ca_gen_image (circuit (), this->dna, seed);
+}
+
+bool GeneticAlgorithm::grid_regen (const uint8_t *const seed,
+const GeneticAlgorithm &parent_a, const GeneticAlgorithm &parent_b, const uint32_t &dna_length,
+const uint32_t *const genes, const uint32_t &count) {
+	const uint16_t start_a = first_change (parent_a, dna_length, genes, count);
+	const uint16_t start_b = first_change (parent_b, dna_length, genes, count);
+
+	// Neither circuit was generated (or both unchanged -- Already caught by Inherit())
+	if (start_a == CA_UNUSED && start_b == CA_UNUSED) return 0;
 
-	// If Memory Allocation Failed
-	if (grid == nullptr) {
-		printf (ANSI_RED "\nERROR: GRID CALLOC FAILED\n" ANSI_RESET);
+	// The parent which the circuit shares more rows with
+	const bool use_a = (start_b == CA_UNUSED) || (start_a != CA_UNUSED && start_a >= start_b);
+	const GeneticAlgorithm &parent = (use_a) ? parent_a : parent_b;
+
+	// Not a single row in common
+	if ( ((use_a) ? start_a : start_b) == 0 ) return 0;
+
+	// Genes differing from that parent -- Only the listed genes may
+	uint32_t changed [count];
+	uint32_t changed_count = 0;
+
+	for (uint32_t k = 0 ; k < count ; k++) {
+		if (this->dna [genes [k]] != parent.dna [genes [k]]) {
+			changed [changed_count] = genes [k];
+			changed_count++;
+		}
 	}
 
-	return grid;
+	ca_regen_image (circuit (), parent.circuit (), this->dna, seed, changed, changed_count);
+	return 1;
 }
 
-void GeneticAlgorithm::grid_gen (const uint8_t *const seed) {
-	// Generates twice,
-	// This effectively generates a (DIMX,2*DIMY) grid from seed.
-	ca_gen_grid (this->grid, this->dna, seed);
-	ca_gen_grid (this->grid, this->dna);
+ca_image GeneticAlgorithm::circuit (void) const {
+	const ca_image out = {image, first, trace, usage};
+	return out;
+}
+
+uint16_t GeneticAlgorithm::first_change (const GeneticAlgorithm &parent, const uint32_t &dna_length,
+const uint32_t *const genes, const uint32_t &count) const {
+	uint16_t start = CA_UNUSED;
+
+	// Parent's circuit was never generated
+	uint64_t any = 0;
+	for (uint32_t w = 0 ; w < CA_USAGE_WORDS (dna_length) ; w++) {
+		any |= parent.usage [w];
+	}
+
+	if (any == 0) return CA_UNUSED;
+
+	for (uint32_t k = 0 ; k < count ; k++) {
+		const uint32_t i = genes [k];
+		if (this->dna [i] != parent.dna [i] && parent.trace [i] < start) start = parent.trace [i];
+	}
+
+	return start;
 }
 
 void GeneticAlgorithm::Sort (GeneticAlgorithm *const array) {
-	// Sort using the helper function defined
-	sort (array, array + get_ga_pop(), compfit_descend);
+	const unsigned int pop = get_ga_pop ();
+	uint64_t *key = sort_key;
+	uint64_t *swap = sort_swap;
+
+	// Inverted keys, sorted in ascending order -- Fittest first. Listed by the previous rank
+	for (unsigned int r = 0 ; r < pop ; r++) {
+		const uint32_t i = rank_index [r];
+		key [r] = ~rank_key (array[i], i);
+	}
+
+	// Histogram of every digit, all in one pass
+	uint32_t count [RADIX_DIGITS][RADIX_SIZE] = {{0}};
+
+	for (unsigned int i = 0 ; i < pop ; i++) {
+		for (unsigned int d = RADIX_SKIP ; d < RADIX_DIGITS ; d++) {
+			count [d][(key [i] >> (RADIX_BITS * d)) & (RADIX_SIZE - 1)]++;
+		}
+	}
+
+	/* Least significant digit first
+		The index digits are not sorted -- Keys start in the previous rank order,
+		and every pass is stable, so ties keep their previous rank.
+		Offspring take the rank of the individual they replaced, same as a sort in place would.
+	*/
+	for (unsigned int d = RADIX_SKIP ; d < RADIX_DIGITS ; d++) {
+		const unsigned int shift = RADIX_BITS * d;
+
+		// Every key has the same digit, nothing to sort
+		if ( count [d][(key [0] >> shift) & (RADIX_SIZE - 1)] == pop ) continue;
+
+		// Bucket offsets
+		uint32_t sum = 0;
+		for (unsigned int b = 0 ; b < RADIX_SIZE ; b++) {
+			const uint32_t tmp = count [d][b];
+			count [d][b] = sum;
+			sum += tmp;
+		}
+
+		for (unsigned int i = 0 ; i < pop ; i++) {
+			swap [ count [d][(key [i] >> shift) & (RADIX_SIZE - 1)]++ ] = key [i];
+		}
+
+		uint64_t *const tmp = key;
+		key = swap;
+		swap = tmp;
+	}
+
+	// Rank permutation, from the index carried by each key
+	for (unsigned int r = 0 ; r < pop ; r++) {
+		rank_index [r] = (uint32_t) (~key [r] & 0xFFFF);
+	}
+
 	return;
 }
 
+const uint32_t *GeneticAlgorithm::get_rank (void) {
+	return rank_index;
+}
+
+void GeneticAlgorithm::neutral_report (void) {
+	printf ("\tNeutral Offspring: %u / %u | %5.2f%% inherited their parent's circuit\n",
+		neutral_count, birth_count, (birth_count > 0) ? (100.0 * neutral_count / birth_count) : 0.0 );
+}
+
 
 
 /* ========== Print Functions ========== */
@@ -493,8 +1049,8 @@ uint8_t *GeneticAlgorithm::get_dna (void) {
 	return this -> dna;
 }
 
-uint8_t **GeneticAlgorithm::get_grid (void) {
-	return this -> grid;
+uint32_t *GeneticAlgorithm::get_image (void) {
+	return this -> image;
 }
 
 uint32_t GeneticAlgorithm::get_fit (void) {
@@ -6,6 +6,20 @@
 #ifndef GACLASS_HPP
 #define GACLASS_HPP
 
+// Generated Circuit -- See ca.hpp
+struct ca_image;
+
+// Repopulate() Job, and Mutate() Plan -- See ga.cpp
+struct ga_breed;
+struct ga_mutate;
+
+/* Parallel Tasks -- See Repopulate()
+	A ga_run function calls 'task (arg, part, parts)' once for every part in [0, parts),
+	each on its own thread, and returns once they are all done. 'parts' is up to the runner.
+*/
+typedef void ga_task (void *const arg, const unsigned int &part, const unsigned int &parts);
+typedef void ga_run (ga_task *const task, void *const arg);
+
 class GeneticAlgorithm {
 
 private:
@@ -16,8 +30,14 @@ private:
 	uint32_t uid;
 	// DNA sequence (Cellular Automaton Rule)
 	uint8_t *dna;
-	// Generated Circuit for each individual
-	uint8_t **grid;
+	// Generated Circuit for each individual -- Packed grid format (global.hpp), PACKED_SIZE words
+	uint32_t *image;
+	// First of the two CA passes generating 'image' -- Same format, kept for grid_regen()
+	uint32_t *first;
+	// Genes used to generate 'image' -- Rule-usage bitmap (ca.hpp), empty if not generated
+	uint64_t *usage;
+	// First row using each gene -- Rule-index trace (ca.hpp), dna_length bytes
+	uint8_t *trace;
 	// Fitness score of the individual
 	// > Consider changing this to float instead of uint.
 	uint32_t fit;
@@ -35,37 +55,89 @@ private:
 
 	/* ========== Compare Functions ========== */
 
-	/* static bool compfit_descend (const GeneticAlgorithm &a, const GeneticAlgorithm &b)
-		Helper function for Sort(). Sorts by fitness in descending order.
-	*/
-	static bool compfit_descend (const GeneticAlgorithm &a, const GeneticAlgorithm &b);
+	/* static uint64_t rank_key (const GeneticAlgorithm &a, const uint32_t &index)
+		Helper function for Sort(). Packs what an individual is ranked by into a single key:
+
+			[63] sol | [62:32] fit | [31:16] gate | [15:0] index
 
-	/* static bool compfit_ascend (const GeneticAlgorithm &a, const GeneticAlgorithm &b)
-		Helper function for Sort(). Sorts by fitness in ascending order.
+		A larger key ranks higher -- Solutions, higher fitness, then higher efficiency first.
+		The array index only rides along, it is never compared. (MAX_GA_POP < 2^16)
 	*/
-	static bool compfit_ascend (const GeneticAlgorithm &a, const GeneticAlgorithm &b);
+	static uint64_t rank_key (const GeneticAlgorithm &a, const uint32_t &index);
 
 
 	/* ========== Genetic Algorithm Operations ========== */
 
-	/* void Crossover
-		(const uint8_t *const dna_a, const uint8_t *const dna_b, const unsigned int &dna_length)
+	/* uint32_t Crossover (const uint8_t *const dna_a, const uint8_t *const dna_b,
+		const unsigned int &dna_length, const unsigned int &mode, const unsigned int &color,
+		uint32_t *const differ)
+
+		Crosses over two parents' dna string, with the operator 'mode' -- "GA Crossover" in the settings.
+
+			CROSS_UNIFORM    -- Each gene from either parent, equal likelyhood.
+			                    One random bit per gene, 8 genes blended at a time.
+			CROSS_ONE_POINT  -- Genes before a random cut from 'dna_a', the rest from 'dna_b'.
+			                    Both parents give at least one gene.
+			CROSS_TWO_POINT  -- Genes between two random cuts from 'dna_b', the rest from 'dna_a'.
+			CROSS_RULE_BLOCK -- Genes grouped by their leading (most significant) neighbor color,
+			                    'color' blocks of color^(NB-1) genes, each from either parent.
 
-		Homogeneously crosses over two parents' dna string.
-		Equal likelyhood any certain dna character will be chosen.
 		Equal split between two parents is not guaranteed.
+
+		Writes the index of every gene where the parents differ to 'differ', in order, unless NULL --
+		The only genes where the offspring can differ from either parent. Up to dna_length indices.
+		Returns the number of genes listed.
+	*/
+	uint32_t Crossover (const uint8_t *const dna_a, const uint8_t *const dna_b,
+		const unsigned int &dna_length, const unsigned int &mode, const unsigned int &color,
+		uint32_t *const differ);
+
+	/* uint32_t Mutate (const ga_mutate &plan, const unsigned int &color,
+		const unsigned int &dna_length, uint32_t *const changed)
+
+		Mutates the dna of a given individual, each gene with probability "GA Mutation Prob".
+		Skips from one mutated gene straight to the next, the gap between them drawn from
+		a geometric distribution -- See mutate_plan(). Minor (75%), swap (20%), or scramble (5%) mutation.
+
+		Writes the index of every gene it changed to 'changed', in order and only once, unless NULL.
+		Up to dna_length indices. A scramble lists its whole range, even genes left as they were.
+		Returns the number of changed genes.
+	*/
+	uint32_t Mutate (const ga_mutate &plan, const unsigned int &color,
+		const unsigned int &dna_length, uint32_t *const changed);
+
+	/* bool Inherit (const GeneticAlgorithm &parent, const uint32_t &dna_length)
+		Neutral mutation check, after Crossover() and Mutate().
+		If every gene the parent's circuit used is unchanged, only unused genes differ,
+		and the offspring grows the exact same circuit -- See ca_gen_image().
+		Copies the parent's circuit, its trace, and scores, marks the offspring as evaluated.
+
+		Returns 1 if inherited. Returns 0 and changes nothing otherwise,
+		or if the parent's circuit was never generated (empty bitmap).
 	*/
-	void Crossover
-	(const uint8_t *const dna_a, const uint8_t *const dna_b, const unsigned int &dna_length);
+	bool Inherit (const GeneticAlgorithm &parent, const uint32_t &dna_length);
 
-	/* void Mutate
-		(const float &mutp, const unsigned int &color, const unsigned int &dna_length)
+	/* static void Breed (const ga_breed &job, const unsigned int &part, const unsigned int &parts)
+		Breeds part 'part' of the offspring of a Repopulate() job, every 'parts'-th one from 'part' on.
+		Tournament selection, Crossover(), Mutate(), then Inherit(), the fitness cache, or grid_regen().
+		Records the fate of each offspring, and hands over each new circuit, see Repopulate().
+		Whole circuits are generated CA_BATCH at a time, see breed_batch().
 
-		Mutates the dna of a given individual.
-		Iterates over every dna chunk, and compares a random number to a set probability.
+		Offspring 'j' is bred from its own PRNG stream, 'job.stream [j]', and only reads the
+		live individuals -- Any number of parts run at once, on any thread, with the same result.
 	*/
-	void Mutate
-	(const float &mutp, const unsigned int &color, const unsigned int &dna_length);
+	static void Breed (const ga_breed &job, const unsigned int &part, const unsigned int &parts);
+
+	/* static void breed_batch (const ga_breed &job, const uint16_t *const batch, const unsigned int &count)
+		Generates the whole circuit of 'count' offspring of a Breed() part, array indices in 'batch',
+		with ca_gen_batch(). Then hands each of them over, see Repopulate().
+	*/
+	static void breed_batch (const ga_breed &job, const uint16_t *const batch, const unsigned int &count);
+
+	/* static void breed_task (void *const arg, const unsigned int &part, const unsigned int &parts)
+		Breed() as a ga_task, 'arg' points to the ga_breed job.
+	*/
+	static void breed_task (void *const arg, const unsigned int &part, const unsigned int &parts);
 
 
 	/* ========== Other Miscellany Operations ========== */
@@ -78,21 +150,6 @@ private:
 	*/
 	void Reset (void);
 
-	/* uint8_t *dna_calloc (const uint32_t &dna_length)
-		DNA dynamic memory allocation
-		Allocates memory for the DNA sequence, for a given DNA length.
-
-		Takes a reference to an constant unsigned 32-bit int 'DNA length'.
-		Allocates and zero-initializes an array of unsigned characters,
-		of length (dna_length).
-
-		Checks whether or not memory was successfully allocated,
-		throws error if failed.
-
-		Returns the pointer to an array of unsigned chars.
-	*/
-	uint8_t *dna_calloc (const uint32_t &dna_length);
-
 	/* void dna_rand_fill (const uint32_t &dna_length)
 		Fills the DNA of the 'this' object with random numbers, modulo CA Color Count.
 		Prints error and does nothing if DNA is a nullptr.
@@ -105,19 +162,46 @@ private:
 	*/
 	void dna_rand_fill (uint8_t *const dna, const uint32_t &dna_length);
 
-	/* uint8_t **grid_calloc (void)
-		Allocate memory for each cell's CA grid.
-		Each individual holds their own CA grid.
-		This reduces the computations required, by only generating each individual's CA grid once.
-		Each CA grids can be evaluated multiple times.
-	*/
-	uint8_t **grid_calloc (void);
-
 	/* void grid_gen (const uint8_t *const seed)
 		Wrapper function for generating each individual's CA grid with their DNA.
+		Generated straight into the packed grid format, see ca_gen_image().
 	*/
 	void grid_gen (const uint8_t *const seed);
 
+	/* void grid_regen (const uint8_t *const seed,
+		const GeneticAlgorithm &parent_a, const GeneticAlgorithm &parent_b, const uint32_t &dna_length,
+		const uint32_t *const genes, const uint32_t &count)
+
+		Incremental grid_gen(), after Crossover() and Mutate(). See ca_regen_image().
+		Starts from the parent whose circuit is used unchanged for the most rows,
+		only the rows from the first one looking up a gene differing from that parent are generated.
+
+		Only the 'count' genes listed in 'genes' are compared with the parents -- Every gene which
+		may differ from either, the merged lists of Crossover() and Mutate(), see Breed().
+
+		Returns 0 and generates nothing if every row would be generated anyway:
+		neither parent's circuit was generated, or the first row already differs.
+		The circuit is then left to grid_gen(), or ca_gen_batch() -- See Repopulate().
+	*/
+	bool grid_regen (const uint8_t *const seed,
+		const GeneticAlgorithm &parent_a, const GeneticAlgorithm &parent_b, const uint32_t &dna_length,
+		const uint32_t *const genes, const uint32_t &count);
+
+	/* ca_image circuit (void) const
+		The generated circuit of the individual, as used by ca_gen_image() / ca_regen_image().
+	*/
+	ca_image circuit (void) const;
+
+	/* uint16_t first_change (const GeneticAlgorithm &parent, const uint32_t &dna_length,
+		const uint32_t *const genes, const uint32_t &count) const
+
+		First row of the parent's circuit which looks up a gene of the parent's differing from ours,
+		among the 'count' genes listed in 'genes'.
+		CA_UNUSED if there are none, or if the parent's circuit was never generated.
+	*/
+	uint16_t first_change (const GeneticAlgorithm &parent, const uint32_t &dna_length,
+		const uint32_t *const genes, const uint32_t &count) const;
+
 public:
 
 	/* ========== Constructors ========== */
@@ -126,21 +210,40 @@ public:
 	GeneticAlgorithm (void);
 
 	/* Single Object Constructor
-		Initializes a single individual, given a DNA length
+		Initializes a single individual, given a DNA length.
+		Takes the next free slot of the population arena for its DNA and CA grid.
 	*/
 	GeneticAlgorithm (const uint32_t &dna_length);
 
-	/* void Free (void)
-		Frees allocated memory for DNA strings & CA Grid
+
+	/* ========== Population Arena ========== */
+
+	/* static bool arena_alloc (const unsigned int &pop, const uint32_t &dna_length)
+		Allocates the DNA and CA grid of 'pop' individuals as one zeroed slab, a slot per individual.
+		Each slot holds the packed CA grid (PACKED_SIZE words), followed by the DNA,
+		padded to a multiple of ARENA_ALIGN bytes, and aligned to it.
+
+		Between the CA grid and the DNA sit the first CA pass (PACKED_SIZE words),
+		the rule-usage bitmap (CA_USAGE_WORDS words), and the rule-index trace (dna_length bytes).
+
+		Each individual holds their own CA grid.
+		This reduces the computations required, by only generating each individual's CA grid once.
+		The rank permutation and the buffers of Sort() are allocated along with it.
+		Returns 0 if the allocation failed.
 	*/
-	void Free (void);
+	static bool arena_alloc (const unsigned int &pop, const uint32_t &dna_length);
+
+	/* static void arena_free (void)
+		Frees the slab, the DNA & CA grid of every individual at once.
+	*/
+	static void arena_free (void);
 
 
 	/* ========== Genetic Algorithm Operations ========== */
 
 	/* static void Selection (GeneticAlgorithm *const array)
 		Selection is done by ranking and age.
-		It is required that the population be sorted by fitness before selection.
+		It is required that the population be ranked by fitness (Sort()) before selection.
 
 		>> Rank-proportional Survivability
 		The higher the rank of an individual, the higher chance of survival.
@@ -160,15 +263,34 @@ public:
 		This is still relatively unlikely, but a possibility to keep in mind.
 
 		NOTE:
-		The array index is equivalent to the rank, because the array is pre-sorted.
+		The array itself is never reordered, the rank is looked up through get_rank().
 		We will be keeping track of the index, because it allows easy access to the original population and its properties, via array[i].
 	*/
 	static void Selection (GeneticAlgorithm *const array);
 
-	/* static void Repopulate (GeneticAlgorithm *const array, const uint8_t *const seed)
+	/* static void Repopulate (GeneticAlgorithm *const array, const uint8_t *const seed,
+		void (*ready) (const unsigned int &index) = NULL, ga_run *const run = NULL)
+
 		Using Tournament Selection Method,
 		choose two parents to procreate and replace a dead individual.
 
+		If given, 'ready' is called with the array index of every offspring,
+		as soon as its circuit is generated -- From any of the breeding threads, possibly at once.
+		It must not change the fitness or age of the live individuals, the parents.
+
+		>> Parallel Breeding
+		If given, the offspring are bred on the threads of 'run', see Breed() -- sim.cpp runs them
+		on its worker pool. Otherwise, they are all bred on the calling thread.
+		Each offspring has its own PRNG stream, jumped ahead of the calling thread's stream,
+		and the tournaments read a snapshot of the live individuals, taken beforehand.
+		The calling thread's stream then long-jumps past them all.
+		A fixed seed always breeds the same offspring, whatever the number of threads.
+
+		Offspring which only differ from a parent in genes its circuit never used, see Inherit(),
+		or found in the fitness cache (memo.hpp), are already evaluated: 'ready' is not called for them.
+		The CA grid of a cached individual is never generated, it is left over from the one it replaced,
+		and its usage bitmap is cleared.
+
 		Splits the population into two vector lists, 'live' and 'dead'.
 		Iterates until all 'dead' individuals are replaced by new offspring.
 
@@ -190,16 +312,34 @@ public:
 			If both parents happen to be the same individual (the individual won twice),
 			generate a random individual entirely.
 	*/
-	static void Repopulate (GeneticAlgorithm *const array, const uint8_t *const seed);
+	static void Repopulate (GeneticAlgorithm *const array, const uint8_t *const seed,
+		void (*ready) (const unsigned int &index) = NULL, ga_run *const run = NULL);
 
 
 	/* ========== Other Miscellany Operations ========== */
 
 	/* static void Sort (GeneticAlgorithm *array)
-		Sorts the entire population by fitness value, in decreasing order.
+		Ranks the entire population by fitness value, in decreasing order.
+		Solutions first, then higher fitness, then higher efficiency. Ties keep their previous rank.
+
+		The individuals are not moved, only their rank permutation is updated, see get_rank().
+		LSD radix sort of rank_key(), 8 bits per pass: O(n), over a compact array of keys.
+		Passes over a digit every key shares are skipped.
 	*/
 	static void Sort (GeneticAlgorithm *array);
 
+	/* static void neutral_report (void)
+		Prints how many offspring inherited their parent's circuit, see Inherit(), since arena_alloc().
+	*/
+	static void neutral_report (void);
+
+	/* static const uint32_t *get_rank (void)
+		Returns the rank permutation: 'get_rank() [r]' is the array index of the individual of rank 'r',
+		rank 0 being the fittest. Valid after Sort(), until the next Repopulate().
+		Before the first Sort(), rank 'r' is simply index 'r'.
+	*/
+	static const uint32_t *get_rank (void);
+
 
 	/* ========== Print Functions ========== */
 
@@ -220,7 +360,7 @@ public:
 
 	uint8_t *get_dna (void);
 
-	uint8_t **get_grid (void);
+	uint32_t *get_image (void);
 
 	uint32_t get_fit (void);
 
@@ -6,6 +6,7 @@
 /* ========== Standard Library Include ========== */
 
 #include <stdio.h>		// Standard I/O
+#include <stdint.h>		// uint definitions
 
 
 
@@ -31,6 +32,8 @@ struct param_ga {
 	float MUTP = 0.05;
 	// Tournament Selection Poolsize
 	unsigned int POOL = 5;
+	// Crossover operator, see GeneticAlgorithm::Crossover()
+	unsigned int CROSS = CROSS_UNIFORM;
 };
 
 // Cellular Automaton Parameters
@@ -55,10 +58,50 @@ struct param_data {
 	bool REPORT = 1;
 };
 
+// Evaluation Parameters
+struct param_eval {
+	// Run each test until the Cell Array settles, instead of a random clock count
+	bool SETTLE = 0;
+	// Evaluation backend, see backend.hpp -- The FPGA is only available on the ARM build
+	#ifdef PC_BUILD
+	unsigned int BACKEND = BACKEND_SOFT;
+	#else
+	unsigned int BACKEND = BACKEND_FPGA;
+	#endif
+	/* How to wait for the wind-up clock, see fpga_wind_clock()
+		Polling needs the S3 status register, sleeping works with every FPGA configuration.
+	*/
+	#ifdef PC_BUILD
+	unsigned int WAIT = WAIT_POLL;
+	#else
+	unsigned int WAIT = WAIT_SLEEP;
+	#endif
+};
+
+// Simulation Parameters
+struct param_sim {
+	// Worker threads breeding and evaluating the population -- PC build only
+	unsigned int THREADS = 1;
+	// PRNG seed, same seed gives the same simulation -- 0 seeds from the current time
+	unsigned int SEED = 0;
+	// Look up the scores of DNA already evaluated, instead of evaluating it again -- See memo.hpp
+	bool MEMO = 1;
+};
+
+// Mock Device Parameters -- See mock.hpp
+struct param_mock {
+	// Cost of a single register read / write, in nanoseconds -- Models the Avalon bus latency
+	unsigned int READ = 0;
+	unsigned int WRITE = 0;
+};
+
 // Declaration of Each Struct
 static param_ga GA;
 static param_ca CA;
 static param_data DATA;
+static param_eval EVAL;
+static param_sim SIM;
+static param_mock MOCK;
 
 // DNA Length Variable
 static unsigned int dna_length = fast_pow (CA.COLOR, CA.NB);
@@ -140,6 +183,10 @@ unsigned int GlobalSettings::get_ga_pool (void) {
 	return GA.POOL;
 }
 
+unsigned int GlobalSettings::get_ga_cross (void) {
+	return GA.CROSS;
+}
+
 
 unsigned int GlobalSettings::get_ca_dimx (void) {
 	return CA.DIMX;
@@ -171,6 +218,41 @@ bool GlobalSettings::get_data_report (void) {
 }
 
 
+bool GlobalSettings::get_eval_settle (void) {
+	return EVAL.SETTLE;
+}
+
+unsigned int GlobalSettings::get_eval_backend (void) {
+	return EVAL.BACKEND;
+}
+
+unsigned int GlobalSettings::get_eval_wait (void) {
+	return EVAL.WAIT;
+}
+
+
+unsigned int GlobalSettings::get_sim_threads (void) {
+	return SIM.THREADS;
+}
+
+unsigned int GlobalSettings::get_sim_seed (void) {
+	return SIM.SEED;
+}
+
+bool GlobalSettings::get_sim_memo (void) {
+	return SIM.MEMO;
+}
+
+
+unsigned int GlobalSettings::get_mock_read (void) {
+	return MOCK.READ;
+}
+
+unsigned int GlobalSettings::get_mock_write (void) {
+	return MOCK.WRITE;
+}
+
+
 unsigned int GlobalSettings::get_dna_length (void) {
 	return dna_length;
 }
@@ -212,6 +294,11 @@ void GlobalSettings::set_ga_pool (const unsigned int &set_val) {
 	return;
 }
 
+void GlobalSettings::set_ga_cross (const unsigned int &set_val) {
+	GA.CROSS = bound (set_val, CROSS_RULE_BLOCK, CROSS_UNIFORM);
+	return;
+}
+
 
 void GlobalSettings::set_ca_dimx (const unsigned int &set_val) {
 	CA.DIMX = bound (set_val, PHYSICAL_DIMX, MIN_DIMX);
@@ -263,3 +350,54 @@ void GlobalSettings::set_data_report (const bool &set_val) {
 	DATA.REPORT = set_val;
 	return;
 }
+
+
+void GlobalSettings::set_eval_settle (const bool &set_val) {
+	EVAL.SETTLE = set_val;
+	return;
+}
+
+void GlobalSettings::set_eval_backend (const unsigned int &set_val) {
+	EVAL.BACKEND = bound (set_val, BACKEND_MOCK, BACKEND_SOFT);
+
+	#ifdef PC_BUILD
+	if (EVAL.BACKEND == BACKEND_FPGA) {
+		printf (ANSI_YELLOW "\tNo FPGA on the PC build, using the mock device instead.\n" ANSI_RESET);
+		EVAL.BACKEND = BACKEND_MOCK;
+	}
+	#endif
+
+	return;
+}
+
+void GlobalSettings::set_eval_wait (const unsigned int &set_val) {
+	EVAL.WAIT = bound (set_val, WAIT_POLL, WAIT_SLEEP);
+	return;
+}
+
+
+void GlobalSettings::set_sim_threads (const unsigned int &set_val) {
+	SIM.THREADS = bound (set_val, MAX_SIM_THREADS, MIN_SIM_THREADS);
+	return;
+}
+
+void GlobalSettings::set_sim_seed (const unsigned int &set_val) {
+	SIM.SEED = set_val;
+	return;
+}
+
+void GlobalSettings::set_sim_memo (const bool &set_val) {
+	SIM.MEMO = set_val;
+	return;
+}
+
+
+void GlobalSettings::set_mock_read (const unsigned int &set_val) {
+	MOCK.READ = bound (set_val, MAX_MOCK_LATENCY, MIN_MOCK_LATENCY);
+	return;
+}
+
+void GlobalSettings::set_mock_write (const unsigned int &set_val) {
+	MOCK.WRITE = bound (set_val, MAX_MOCK_LATENCY, MIN_MOCK_LATENCY);
+	return;
+}
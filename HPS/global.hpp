@@ -13,15 +13,24 @@
 	Should be updated every commit / update.
 */
 #ifdef PC_BUILD
-#define VERSION "3.07.00 PC BUILD"
+#define VERSION "3.31.13 PC BUILD"
 #else
-#define VERSION "3.07.00"
+#define VERSION "3.31.13"
 #endif
 
 // Physical FPGA Cell Array Dimension
 #define PHYSICAL_DIMX 64
 #define PHYSICAL_DIMY 64
 
+/* Packed Grid Format -- Same as the FPGA Cell Array RAM, the S2 port
+	4 bits per cell, 8 cells per 32-bit word, 8 words per row. 512 words, 2 KB per grid.
+	Cell (y,x) is nibble (x % 8) of word (y * PACKED_ROW + x / 8), lowest nibble first.
+	Circuits are stored in this format, see ca_gen_image().
+*/
+#define PACKED_CELL 8
+#define PACKED_ROW (PHYSICAL_DIMX / PACKED_CELL)
+#define PACKED_SIZE (PHYSICAL_DIMY * PACKED_ROW)
+
 // Minimum Cell Array Dimension
 #define MIN_DIMX 1
 #define MIN_DIMY 1
@@ -79,6 +88,30 @@
 #define MAX_GA_POOL GA.POP
 #define MIN_GA_POOL 1
 
+// Crossover Operators -- See GeneticAlgorithm::Crossover()
+#define CROSS_UNIFORM 0
+#define CROSS_ONE_POINT 1
+#define CROSS_TWO_POINT 2
+#define CROSS_RULE_BLOCK 3
+
+// Evaluation Backends -- See backend.hpp
+#define BACKEND_SOFT 0
+#define BACKEND_FPGA 1
+#define BACKEND_MOCK 2
+
+// Wind-up Clock Wait Strategies -- See fpga_wind_clock()
+#define WAIT_SLEEP 0
+#define WAIT_SPIN 1
+#define WAIT_POLL 2
+
+// Max Simulation Worker Threads -- Breeding, and software evaluation
+#define MAX_SIM_THREADS 64
+#define MIN_SIM_THREADS 1
+
+// Max Mock Device Register Latency (Nanoseconds)
+#define MAX_MOCK_LATENCY 1000000
+#define MIN_MOCK_LATENCY 0
+
 // Estimated Number of Individuals Evaluated per Second - Calculated manually
 #define INDV_PER_SEC 233
 
@@ -94,6 +127,7 @@ namespace GlobalSettings {
 	unsigned int get_ga_gen (void);
 	float get_ga_mutp (void);
 	unsigned int get_ga_pool (void);
+	unsigned int get_ga_cross (void);
 
 	unsigned int get_ca_dimx (void);
 	unsigned int get_ca_dimy (void);
@@ -104,6 +138,17 @@ namespace GlobalSettings {
 	bool get_data_export (void);
 	bool get_data_report (void);
 
+	bool get_eval_settle (void);
+	unsigned int get_eval_backend (void);
+	unsigned int get_eval_wait (void);
+
+	unsigned int get_sim_threads (void);
+	unsigned int get_sim_seed (void);
+	bool get_sim_memo (void);
+
+	unsigned int get_mock_read (void);
+	unsigned int get_mock_write (void);
+
 	unsigned int get_dna_length (void);
 
 	/* ========== Setter Functions ========== */
@@ -112,6 +157,7 @@ namespace GlobalSettings {
 	void set_ga_gen (const unsigned int &set_val);
 	void set_ga_mutp (const float &set_val);
 	void set_ga_pool (const unsigned int &set_val);
+	void set_ga_cross (const unsigned int &set_val);
 
 	void set_ca_dimx (const unsigned int &set_val);
 	void set_ca_dimy (const unsigned int &set_val);
@@ -122,6 +168,17 @@ namespace GlobalSettings {
 	void set_data_export (const bool &set_val);
 	void set_data_report (const bool &set_val);
 
+	void set_eval_settle (const bool &set_val);
+	void set_eval_backend (const unsigned int &set_val);
+	void set_eval_wait (const unsigned int &set_val);
+
+	void set_sim_threads (const unsigned int &set_val);
+	void set_sim_seed (const unsigned int &set_val);
+	void set_sim_memo (const bool &set_val);
+
+	void set_mock_read (const unsigned int &set_val);
+	void set_mock_write (const unsigned int &set_val);
+
 };
 
 #endif
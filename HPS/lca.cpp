@@ -0,0 +1,641 @@
+/* Main C++ File for the Software Logical Cell Array
+	Repo: https://github.com/mimocha/ga-logic-circuit
+	Copyright (c) 2018 Chawit Leosrisook
+*/
+
+/* ========== Standard Library Include ========== */
+
+#include <stdint.h>		// uint definitions
+#include <string.h>		// memset
+
+// AVX2 batched Cell Array -- See batch_select()
+#if defined (__x86_64__) || defined (__i386__)
+	#define LCA_SIMD_X86
+#endif
+
+
+
+/* ========== Custom Header Include ========== */
+
+#include "global.hpp"
+#include "lca.hpp"
+
+
+
+/* ========== LCA Define ========== */
+
+// Cell RAM Data Width (Bits) -- Only the lower 2 bits are used by the cell
+#define CELL_DATA_WIDTH 4
+
+// Numbers of Cells in one S2 word (32-bit / 4-bit)
+#define CELL_IN_WORD 8
+
+// Numbers of S2 words per row
+#define WORD_IN_ROW (PHYSICAL_DIMX / CELL_IN_WORD)
+
+// Bottom-most Row Index
+#define LAST_ROW (PHYSICAL_DIMY - 1)
+
+
+
+/* ========== Helper Functions ========== */
+
+/* static inline uint64_t next_cell (const uint64_t &row)
+	Returns the 'Input 1' wire of an entire row.
+	Bit x of the result is bit (x+1) % DIMX of 'row'. (Rotate right by one)
+*/
+static inline uint64_t next_cell (const uint64_t &row) {
+	return (row >> 1) | (row << (PHYSICAL_DIMX - 1));
+}
+
+/* static inline uint64_t prev_cell (const uint64_t &row)
+	Inverse of next_cell(). Bit x+1 of the result is bit x of 'row'. (Rotate left by one)
+	Marks the 'Input 1' source cell of every cell marked in 'row'.
+*/
+static inline uint64_t prev_cell (const uint64_t &row) {
+	return (row << 1) | (row >> (PHYSICAL_DIMX - 1));
+}
+
+/* static uint32_t cone_rows
+	(const uint64_t *const use0, const uint64_t *const use1, const uint64_t &mask, uint64_t *const cone)
+
+	Cone of influence -- See header.
+	'use0' and 'use1' mark the cells reading Input 0 and Input 1, one word per row.
+	Writes the cone to 'cone', and returns the number of rows from the top containing the cone.
+*/
+static uint32_t cone_rows
+(const uint64_t *const use0, const uint64_t *const use1, const uint64_t &mask, uint64_t *const cone) {
+	memset (cone, 0, PHYSICAL_DIMY * sizeof (uint64_t));
+	cone [0] = mask;
+
+	// Walks down the rows, until the wrap-around stops adding cells to the top-most row
+	bool grown = 1;
+
+	while (grown) {
+		for (uint32_t y = 0 ; y < LAST_ROW ; y++) {
+			cone [y+1] |= (cone [y] & use0 [y]) | prev_cell (cone [y] & use1 [y]);
+		}
+
+		// Bottom-most row -- Input 1 comes from the top-most row, Input 0 from Linux
+		const uint64_t top = cone [0] | prev_cell (cone [LAST_ROW] & use1 [LAST_ROW]);
+
+		grown = (top != cone [0]);
+		cone [0] = top;
+	}
+
+	uint32_t rows = PHYSICAL_DIMY;
+	while (rows > 1 && cone [rows-1] == 0) rows--;
+
+	return rows;
+}
+
+/* static inline uint64_t hash_word (const uint64_t &word, const uint64_t &index)
+	Hash of a single register word, mixed with its position in the Cell Array.
+	Words are hashed independently and summed, keeping the multiplications out of a serial chain.
+*/
+static inline uint64_t hash_word (const uint64_t &word, const uint64_t &index) {
+	return (word ^ (index * 0x9E3779B97F4A7C15ULL)) * 0xBF58476D1CE4E5B9ULL;
+}
+
+/* template <class CellArray>
+	static uint16_t run_clock (CellArray &lca, const uint16_t &pulses, const bool &stop)
+
+	Runs up to 'pulses' clock pulses, with Brent's cycle detection -- See header.
+	Returns the cycle length found, 1 for a fixed point, or 0 if none was found.
+
+	If 'stop' is set, returns as soon as a cycle is found.
+	If not, the remaining pulses are skipped by whole cycles,
+	leaving the Cell Array in the same state as running every pulse.
+*/
+template <class CellArray>
+static uint16_t run_clock (CellArray &lca, const uint16_t &pulses, const bool &stop) {
+	uint32_t power = 1;
+	uint32_t length = 0;
+	uint16_t cycle = 0;
+	uint16_t t = 0;
+
+	lca.save_state (lca.state_hash ());
+
+	while (t < pulses) {
+		const bool changed = lca.clock ();
+		t++;
+
+		// Fixed point -- Nothing changes from here on
+		if (changed == 0) {
+			cycle = 1;
+			break;
+		}
+
+		// Limit cycle -- Back to the saved state after 'length' clocks
+		const uint64_t hash = lca.state_hash ();
+		length++;
+
+		if ( lca.is_saved_state (hash) ) {
+			cycle = length;
+			break;
+		}
+
+		// Moves the saved state forward at every power of two
+		if (length == power) {
+			lca.save_state (hash);
+			power <<= 1;
+			length = 0;
+		}
+	}
+
+	if (stop == 0 && cycle > 1) {
+		const uint16_t remain = (pulses - t) % cycle;
+
+		for (uint16_t r = 0 ; r < remain ; r++) {
+			lca.clock ();
+		}
+	}
+
+	return cycle;
+}
+
+
+
+/* ========== Cone of Influence ========== */
+
+void lca_cone (const uint8_t *const *const grid, const uint64_t &mask, uint64_t *const cone) {
+	uint64_t use0 [PHYSICAL_DIMY];
+	uint64_t use1 [PHYSICAL_DIMY];
+
+	for (uint32_t y = 0 ; y < PHYSICAL_DIMY ; y++) {
+		use0 [y] = 0;
+		use1 [y] = 0;
+
+		for (uint32_t x = 0 ; x < PHYSICAL_DIMX ; x++) {
+			const uint8_t ram = grid [y][x] & 0x3;
+
+			use0 [y] |= (uint64_t) (ram & 0x1) << x;
+			use1 [y] |= (uint64_t) (ram >> 1) << x;
+		}
+	}
+
+	cone_rows (use0, use1, mask, cone);
+}
+
+
+
+// =====================================================
+// LOGICAL CELL ARRAY CLASS METHODS
+// =====================================================
+
+/* ========== Constructors ========== */
+
+LogicCellArray::LogicCellArray (void) {
+	reset ();
+}
+
+void LogicCellArray::reset (void) {
+	clear_ram ();
+	memset (state, 0, sizeof (state));
+	memset (saved, 0, sizeof (saved));
+	linux_in = 0;
+	saved_hash = 0;
+	cycle = 0;
+}
+
+
+
+/* ========== Cell RAM ========== */
+
+void LogicCellArray::ram_write (const uint32_t &offset, const uint32_t &data) {
+	// Address decoding -- 8 words per row, 8 cells per word
+	const uint32_t y = offset / WORD_IN_ROW;
+	const uint32_t x0 = (offset % WORD_IN_ROW) * CELL_IN_WORD;
+
+	// Out of range addresses are ignored by the decoder
+	if (y >= PHYSICAL_DIMY) return;
+
+	// Bits of the 8 addressed cells
+	const uint64_t slot = (uint64_t) 0xFF << x0;
+
+	uint64_t a = 0;
+	uint64_t b = 0;
+	uint64_t n = 0;
+
+	for (uint32_t i = 0 ; i < CELL_IN_WORD ; i++) {
+		const uint32_t ram = (data >> (CELL_DATA_WIDTH * i)) & 0x3;
+		const uint64_t bit = (uint64_t) 1 << (x0 + i);
+
+		if (ram == 1) a |= bit;
+		if (ram == 2) b |= bit;
+		if (ram == 3) n |= bit;
+	}
+
+	pass_a [y] = (pass_a [y] & ~slot) | a;
+	pass_b [y] = (pass_b [y] & ~slot) | b;
+	nand [y] = (nand [y] & ~slot) | n;
+
+	// Any cell may be written to, the cone no longer holds
+	depth = PHYSICAL_DIMY;
+}
+
+void LogicCellArray::set_grid (const uint8_t *const *const grid) {
+	for (uint32_t y = 0 ; y < PHYSICAL_DIMY ; y++) {
+		uint64_t a = 0;
+		uint64_t b = 0;
+		uint64_t n = 0;
+
+		for (uint32_t x = 0 ; x < PHYSICAL_DIMX ; x++) {
+			const uint8_t ram = grid [y][x] & 0x3;
+			const uint64_t bit = (uint64_t) 1 << x;
+
+			if (ram == 1) a |= bit;
+			if (ram == 2) b |= bit;
+			if (ram == 3) n |= bit;
+		}
+
+		pass_a [y] = a;
+		pass_b [y] = b;
+		nand [y] = n;
+	}
+
+	depth = PHYSICAL_DIMY;
+}
+
+void LogicCellArray::clear_ram (void) {
+	memset (pass_a, 0, sizeof (pass_a));
+	memset (pass_b, 0, sizeof (pass_b));
+	memset (nand, 0, sizeof (nand));
+	depth = PHYSICAL_DIMY;
+}
+
+void LogicCellArray::set_cone (const uint64_t &mask) {
+	uint64_t use0 [PHYSICAL_DIMY];
+	uint64_t use1 [PHYSICAL_DIMY];
+	uint64_t cone [PHYSICAL_DIMY];
+
+	for (uint32_t y = 0 ; y < PHYSICAL_DIMY ; y++) {
+		use0 [y] = pass_a [y] | nand [y];
+		use1 [y] = pass_b [y] | nand [y];
+	}
+
+	depth = cone_rows (use0, use1, mask, cone);
+
+	for (uint32_t y = 0 ; y < PHYSICAL_DIMY ; y++) {
+		pass_a [y] &= cone [y];
+		pass_b [y] &= cone [y];
+		nand [y] &= cone [y];
+	}
+}
+
+
+
+/* ========== Input / Output ========== */
+
+void LogicCellArray::set_input (const uint64_t &data) {
+	linux_in = data;
+}
+
+uint64_t LogicCellArray::get_output (void) {
+	return state [0];
+}
+
+
+
+/* ========== Clock ========== */
+
+bool LogicCellArray::clock (void) {
+	/* Updates in place, from top to bottom.
+		Row y reads row y+1, which is only overwritten after row y.
+		The bottom-most row reads row 0, which is overwritten first -- keep a copy.
+	*/
+	const uint64_t top = state [0];
+	uint64_t change = 0;
+
+	// Rows below the cone of influence are left as they are -- See set_cone()
+	const uint32_t rows = (depth < PHYSICAL_DIMY) ? depth : LAST_ROW;
+
+	for (uint32_t y = 0 ; y < rows ; y++) {
+		const uint64_t in0 = state [y+1];
+		const uint64_t in1 = next_cell (in0);
+		const uint64_t next = (pass_a [y] & in0) | (pass_b [y] & in1) | (nand [y] & ~(in0 & in1));
+
+		change |= next ^ state [y];
+		state [y] = next;
+	}
+
+	// Bottom-most row -- Linux input & loop from the top-most row
+	if (depth == PHYSICAL_DIMY) {
+		const uint64_t in0 = linux_in;
+		const uint64_t in1 = next_cell (top);
+		const uint64_t next =
+			(pass_a [LAST_ROW] & in0) | (pass_b [LAST_ROW] & in1) | (nand [LAST_ROW] & ~(in0 & in1));
+
+		change |= next ^ state [LAST_ROW];
+		state [LAST_ROW] = next;
+	}
+
+	return (change != 0);
+}
+
+void LogicCellArray::wind_clock (const uint16_t &cycles) {
+	// The last count does not make a full clock pulse -- See header
+	const uint16_t pulses = (cycles > 0) ? (cycles - 1) : 0;
+
+	cycle = run_clock (*this, pulses, 0);
+}
+
+uint16_t LogicCellArray::settle (const uint16_t &limit) {
+	cycle = run_clock (*this, limit, 1);
+	return cycle;
+}
+
+uint16_t LogicCellArray::get_cycle (void) {
+	return cycle;
+}
+
+
+
+/* ========== Cycle Detection ========== */
+
+uint64_t LogicCellArray::state_hash (void) {
+	uint64_t hash = 0;
+
+	for (uint32_t y = 0 ; y < PHYSICAL_DIMY ; y++) {
+		hash += hash_word (state [y], y);
+	}
+
+	return hash;
+}
+
+void LogicCellArray::save_state (const uint64_t &hash) {
+	memcpy (saved, state, sizeof (saved));
+	saved_hash = hash;
+}
+
+bool LogicCellArray::is_saved_state (const uint64_t &hash) {
+	if (hash != saved_hash) return 0;
+	return (memcmp (saved, state, sizeof (saved)) == 0);
+}
+
+
+
+// =====================================================
+// BATCHED LOGICAL CELL ARRAY CLASS METHODS
+// =====================================================
+
+/* ========== Constructors ========== */
+
+BatchCellArray::BatchCellArray (void) {
+	reset ();
+}
+
+void BatchCellArray::reset (void) {
+	memset (pass_a, 0, sizeof (pass_a));
+	memset (pass_b, 0, sizeof (pass_b));
+	memset (nand, 0, sizeof (nand));
+	memset (state, 0, sizeof (state));
+	memset (saved, 0, sizeof (saved));
+	memset (&linux_in, 0, sizeof (linux_in));
+	memset (&change, 0, sizeof (change));
+	saved_hash = 0;
+	cycle = 0;
+	depth = PHYSICAL_DIMY;
+}
+
+
+
+/* ========== Cell RAM ========== */
+
+void BatchCellArray::set_image (const unsigned int &lane, const uint32_t *const image) {
+	if (lane >= LCA_BATCH) return;
+
+	for (uint32_t y = 0 ; y < PHYSICAL_DIMY ; y++) {
+		uint64_t a = 0;
+		uint64_t b = 0;
+		uint64_t n = 0;
+
+		for (uint32_t w = 0 ; w < WORD_IN_ROW && image != NULL ; w++) {
+			const uint32_t data = image [y * WORD_IN_ROW + w];
+
+			for (uint32_t i = 0 ; i < CELL_IN_WORD ; i++) {
+				const uint32_t ram = (data >> (CELL_DATA_WIDTH * i)) & 0x3;
+				const uint64_t bit = (uint64_t) 1 << (w * CELL_IN_WORD + i);
+
+				if (ram == 1) a |= bit;
+				if (ram == 2) b |= bit;
+				if (ram == 3) n |= bit;
+			}
+		}
+
+		pass_a [y][lane] = a;
+		pass_b [y][lane] = b;
+		nand [y][lane] = n;
+	}
+
+	depth = PHYSICAL_DIMY;
+}
+
+void BatchCellArray::set_cone (const uint64_t &mask) {
+	uint64_t use0 [PHYSICAL_DIMY];
+	uint64_t use1 [PHYSICAL_DIMY];
+	uint64_t cone [PHYSICAL_DIMY];
+
+	depth = 1;
+
+	for (uint32_t k = 0 ; k < LCA_BATCH ; k++) {
+		for (uint32_t y = 0 ; y < PHYSICAL_DIMY ; y++) {
+			use0 [y] = pass_a [y][k] | nand [y][k];
+			use1 [y] = pass_b [y][k] | nand [y][k];
+		}
+
+		const uint32_t rows = cone_rows (use0, use1, mask, cone);
+		if (rows > depth) depth = rows;
+
+		for (uint32_t y = 0 ; y < PHYSICAL_DIMY ; y++) {
+			pass_a [y][k] &= cone [y];
+			pass_b [y][k] &= cone [y];
+			nand [y][k] &= cone [y];
+		}
+	}
+}
+
+
+
+/* ========== Input / Output ========== */
+
+void BatchCellArray::set_input (const uint64_t &data) {
+	for (uint32_t k = 0 ; k < LCA_BATCH ; k++) {
+		linux_in [k] = data;
+	}
+}
+
+uint64_t BatchCellArray::get_output (const unsigned int &lane) {
+	if (lane >= LCA_BATCH) return 0;
+	return state [0][lane];
+}
+
+
+
+/* ========== Clock ========== */
+
+/* static inline bool batch_clock (lca_vec_t *const state, const lca_vec_t *const pass_a,
+	const lca_vec_t *const pass_b, const lca_vec_t *const nand, const lca_vec_t &linux_in,
+	lca_vec_t &change, const uint32_t &depth)
+
+	Body of BatchCellArray::clock(), inlined into a copy for each instruction set -- See batch_select().
+*/
+static inline __attribute__ ((always_inline)) bool batch_clock (lca_vec_t *const state,
+const lca_vec_t *const pass_a, const lca_vec_t *const pass_b, const lca_vec_t *const nand,
+const lca_vec_t &linux_in, lca_vec_t &change, const uint32_t &depth) {
+	// Updates in place, from top to bottom -- See LogicCellArray::clock()
+	const lca_vec_t top = state [0];
+	lca_vec_t diff = {0};
+
+	// Rows below the cone of influence are left as they are -- See set_cone()
+	const uint32_t rows = (depth < PHYSICAL_DIMY) ? depth : LAST_ROW;
+
+	for (uint32_t y = 0 ; y < rows ; y++) {
+		const lca_vec_t in0 = state [y+1];
+		// Input 1 wire, same as next_cell() for every lane
+		const lca_vec_t in1 = (in0 >> 1) | (in0 << (PHYSICAL_DIMX - 1));
+		const lca_vec_t next = (pass_a [y] & in0) | (pass_b [y] & in1) | (nand [y] & ~(in0 & in1));
+
+		diff |= next ^ state [y];
+		state [y] = next;
+	}
+
+	// Bottom-most row -- Linux input & loop from the top-most row
+	if (depth == PHYSICAL_DIMY) {
+		const lca_vec_t in0 = linux_in;
+		const lca_vec_t in1 = (top >> 1) | (top << (PHYSICAL_DIMX - 1));
+		const lca_vec_t next =
+			(pass_a [LAST_ROW] & in0) | (pass_b [LAST_ROW] & in1) | (nand [LAST_ROW] & ~(in0 & in1));
+
+		diff |= next ^ state [LAST_ROW];
+		state [LAST_ROW] = next;
+	}
+
+	change = diff;
+
+	uint64_t any = 0;
+	for (uint32_t k = 0 ; k < LCA_BATCH ; k++) {
+		any |= diff [k];
+	}
+
+	return (any != 0);
+}
+
+/* static inline uint64_t batch_hash (const lca_vec_t *const state)
+	Body of BatchCellArray::state_hash(), same as batch_clock().
+	hash_word() of every word, index (y * LCA_BATCH + k), one row at a time.
+*/
+static inline __attribute__ ((always_inline)) uint64_t batch_hash (const lca_vec_t *const state) {
+	// Index term of hash_word(), moved one row down at a time
+	lca_vec_t mix;
+	lca_vec_t step;
+	lca_vec_t sum = {0};
+
+	for (uint32_t k = 0 ; k < LCA_BATCH ; k++) {
+		mix [k] = k * 0x9E3779B97F4A7C15ULL;
+		step [k] = LCA_BATCH * 0x9E3779B97F4A7C15ULL;
+	}
+
+	for (uint32_t y = 0 ; y < PHYSICAL_DIMY ; y++) {
+		sum += (state [y] ^ mix) * 0xBF58476D1CE4E5B9ULL;
+		mix += step;
+	}
+
+	uint64_t hash = 0;
+	for (uint32_t k = 0 ; k < LCA_BATCH ; k++) {
+		hash += sum [k];
+	}
+
+	return hash;
+}
+
+static bool batch_clock_base (lca_vec_t *const state,
+const lca_vec_t *const pass_a, const lca_vec_t *const pass_b, const lca_vec_t *const nand,
+const lca_vec_t &linux_in, lca_vec_t &change, const uint32_t &depth) {
+	return batch_clock (state, pass_a, pass_b, nand, linux_in, change, depth);
+}
+
+static uint64_t batch_hash_base (const lca_vec_t *const state) {
+	return batch_hash (state);
+}
+
+#ifdef LCA_SIMD_X86
+
+__attribute__ ((target ("avx2")))
+static bool batch_clock_avx2 (lca_vec_t *const state,
+const lca_vec_t *const pass_a, const lca_vec_t *const pass_b, const lca_vec_t *const nand,
+const lca_vec_t &linux_in, lca_vec_t &change, const uint32_t &depth) {
+	return batch_clock (state, pass_a, pass_b, nand, linux_in, change, depth);
+}
+
+__attribute__ ((target ("avx2")))
+static uint64_t batch_hash_avx2 (const lca_vec_t *const state) {
+	return batch_hash (state);
+}
+
+#endif
+
+/* static bool batch_select (void)
+	Returns 1 if the CPU runs the AVX2 copies of batch_clock() and batch_hash().
+	Picked at run time, the PC build only assumes SSE2 -- See PC_ARCH in the MAKEFILE.
+*/
+static bool batch_select (void) {
+	#ifdef LCA_SIMD_X86
+	__builtin_cpu_init ();
+	return __builtin_cpu_supports ("avx2");
+	#else
+	return 0;
+	#endif
+}
+
+static const bool batch_avx2 = batch_select ();
+
+bool BatchCellArray::clock (void) {
+	#ifdef LCA_SIMD_X86
+	if (batch_avx2) return batch_clock_avx2 (state, pass_a, pass_b, nand, linux_in, change, depth);
+	#endif
+
+	return batch_clock_base (state, pass_a, pass_b, nand, linux_in, change, depth);
+}
+
+void BatchCellArray::wind_clock (const uint16_t &cycles) {
+	const uint16_t pulses = (cycles > 0) ? (cycles - 1) : 0;
+
+	cycle = run_clock (*this, pulses, 0);
+}
+
+uint16_t BatchCellArray::settle (const uint16_t &limit) {
+	cycle = run_clock (*this, limit, 1);
+	return cycle;
+}
+
+uint16_t BatchCellArray::get_cycle (void) {
+	return cycle;
+}
+
+bool BatchCellArray::get_unstable (const unsigned int &lane) {
+	if (lane >= LCA_BATCH) return 0;
+	return (change [lane] != 0);
+}
+
+
+
+/* ========== Cycle Detection ========== */
+
+uint64_t BatchCellArray::state_hash (void) {
+	#ifdef LCA_SIMD_X86
+	if (batch_avx2) return batch_hash_avx2 (state);
+	#endif
+
+	return batch_hash_base (state);
+}
+
+void BatchCellArray::save_state (const uint64_t &hash) {
+	memcpy (saved, state, sizeof (saved));
+	saved_hash = hash;
+}
+
+bool BatchCellArray::is_saved_state (const uint64_t &hash) {
+	if (hash != saved_hash) return 0;
+	return (memcmp (saved, state, sizeof (saved)) == 0);
+}
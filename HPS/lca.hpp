@@ -0,0 +1,358 @@
+/* Header File for the Software Logical Cell Array
+	Repo: https://github.com/mimocha/ga-logic-circuit
+	Copyright (c) 2018 Chawit Leosrisook
+*/
+
+#ifndef LCA_HPP
+#define LCA_HPP
+
+/* Notes on the Software Logical Cell Array
+	Cycle-accurate software model of the FPGA module "Logical Cell Array".
+	Mirrors the verilog files cell_array.v, cell_row.v, cell_row_lin.v, and logic_cell.v
+
+	Wiring (same as the FPGA):
+		Row y, for y < DIMY-1 (cell_row):
+			Input 0 := Row y+1, cell x
+			Input 1 := Row y+1, cell (x+1) % DIMX
+		Row DIMY-1, the bottom-most row (cell_row_lin):
+			Input 0 := Linux input, bit x
+			Input 1 := Row 0, cell (x+1) % DIMX
+		Row 0 is the output, bit x := cell x
+
+	Cell RAM (logic_cell):
+		RAM 1 | RAM 0 |   Output
+		------+-------+----------
+		    0 |     0 |        0
+		    0 |     1 | Input [0]
+		    1 |     0 | Input [1]
+		    1 |     1 | Input [0] NAND Input [1]
+
+	Bit-parallel representation:
+	Each 64-cell row is packed into a single uint64_t, bit x being cell x.
+	The 2-bit RAM of each cell is pre-decoded into three select masks per row,
+	so the next state of an entire row is computed with a handful of word-wide operations:
+
+		next = (pass_a & in0) | (pass_b & in1) | (nand & ~(in0 & in1))
+
+	Every cell is a register, updated on the same clock edge.
+
+	Fixed-point / limit-cycle detection:
+	With a constant input, the Cell Array is a deterministic finite state machine,
+	so its register state must eventually reach a fixed point, or repeat in a limit cycle.
+	wind_clock() and settle() watch for this with Brent's cycle detection:
+	a copy of the state is saved at every power-of-two step, and each following state
+	is compared to it, by a 64-bit state hash first, then word by word.
+
+	Once the cycle length is known, the rest of a wind-up only needs (remaining % length) clocks,
+	so the resulting state is exactly the same as running every clock.
+	Most circuits reach a fixed point within a few dozen clocks, instead of the 256 - 511 clocks
+	used by the evaluation functions.
+
+	Cone-of-influence pruning:
+	Usually only a few output bits are scored (TruthTable mask).
+	Walking backwards from those output cells, through the wires actually read by each cell,
+	gives the set of cells that can influence a scored output -- the cone of influence.
+	Cell (y,x) reads (y+1,x) with RAM 1 or 3, and (y+1,x+1) with RAM 2 or 3;
+	the bottom-most row reads (0,x+1) instead, so the walk wraps around from the bottom to the top.
+
+	set_cone() clears the RAM of every cell outside the cone; they could not change a scored output.
+	Rows below the cone are not simulated at all.
+	Pruned cells also stop oscillating, so only the scored part of the circuit needs to settle.
+*/
+
+/* void lca_cone (const uint8_t *const *const grid, const uint64_t &mask, uint64_t *const cone)
+	Finds the cone of influence of the output bits in 'mask', for a (PHYSICAL_DIMY x PHYSICAL_DIMX) grid.
+	Writes one word per row to 'cone' (PHYSICAL_DIMY words), bit x of 'cone [y]' set for cell (y,x)
+	if it can influence any output bit in 'mask'.
+*/
+void lca_cone (const uint8_t *const *const grid, const uint64_t &mask, uint64_t *const cone);
+
+#if (PHYSICAL_DIMX != 64)
+	#error "Software Logical Cell Array requires PHYSICAL_DIMX == 64"
+#endif
+
+class LogicCellArray {
+
+private:
+
+	/* ========== Properties ========== */
+
+	// Pre-decoded Cell RAM -- One mask per row, one bit per cell
+	uint64_t pass_a [PHYSICAL_DIMY];
+	uint64_t pass_b [PHYSICAL_DIMY];
+	uint64_t nand [PHYSICAL_DIMY];
+
+	// Cell Output Registers -- One word per row, one bit per cell
+	uint64_t state [PHYSICAL_DIMY];
+
+	// Linux Input Register -- Input to the bottom-most row
+	uint64_t linux_in;
+
+	// Cycle Detection -- Saved register state and its hash, cycle length of the last wind-up
+	uint64_t saved [PHYSICAL_DIMY];
+	uint64_t saved_hash;
+	uint16_t cycle;
+
+	// Number of rows simulated, from the top -- Reduced by set_cone()
+	uint32_t depth;
+
+public:
+
+	/* ========== Constructors ========== */
+
+	/* Default Constructor
+		Equivalent to the FPGA reset, all RAM and registers set to zero.
+	*/
+	LogicCellArray (void);
+
+	/* void reset (void)
+		Resets the Cell Array. Equivalent to the 'rst' signal.
+		Clears all cell RAM, cell outputs, and Linux input.
+	*/
+	void reset (void);
+
+
+	/* ========== Cell RAM ========== */
+
+	/* void ram_write (const uint32_t &offset, const uint32_t &data)
+		Equivalent to a single 32-bit write to the S2 port (RAM).
+		Sets the RAM of the 8 cells addressed by 'offset', 4-bits per cell, LSB first.
+		See the packed grid format in global.hpp.
+	*/
+	void ram_write (const uint32_t &offset, const uint32_t &data);
+
+	/* void set_grid (const uint8_t *const *const grid)
+		Sets the RAM of every cell from a (PHYSICAL_DIMY x PHYSICAL_DIMX) grid.
+		Same result as packing the grid and writing all 512 words with ram_write().
+	*/
+	void set_grid (const uint8_t *const *const grid);
+
+	/* void clear_ram (void)
+		Sets the RAM of every cell to zero. Does not touch the cell outputs.
+	*/
+	void clear_ram (void);
+
+	/* void set_cone (const uint64_t &mask)
+		Cone-of-influence pruning -- See notes.
+		Clears the RAM of every cell which cannot influence the output bits in 'mask',
+		and stops simulating the rows below the cone.
+		The output bits in 'mask' behave exactly the same, other output bits are meaningless.
+		Lasts until the next set_grid() or clear_ram().
+	*/
+	void set_cone (const uint64_t &mask);
+
+
+	/* ========== Input / Output ========== */
+
+	/* void set_input (const uint64_t &data)
+		Sets the Linux input register. Takes effect on the next clock.
+	*/
+	void set_input (const uint64_t &data);
+
+	/* uint64_t get_output (void)
+		Returns the current output of the top-most row (Row 0).
+	*/
+	uint64_t get_output (void);
+
+
+	/* ========== Clock ========== */
+
+	/* bool clock (void)
+		Advances the entire Cell Array by a single clock cycle.
+		Returns 1 if any cell output has changed, 0 if the state is a fixed point.
+	*/
+	bool clock (void);
+
+	/* void wind_clock (const uint16_t &cycles)
+		Equivalent to writing 'cycles' to the S3 port (Wind-up Clock).
+
+		The wind-up clock delivers (cycles - 1) full clock pulses to the Cell Array.
+		The last pulse is cut short, as the counter reaches zero on the same clock edge.
+		Verified against the FPGA with the NAND test of fpga_verify(), which only passes
+		with an odd number of clock pulses for fpga_wind_clock (100).
+
+		Stops simulating early once a fixed point or a limit cycle is found -- See notes.
+		The resulting state is the same as running every clock pulse.
+	*/
+	void wind_clock (const uint16_t &cycles);
+
+	/* uint16_t settle (const uint16_t &limit)
+		Runs up to 'limit' clock pulses, stopping as soon as a fixed point or a limit cycle is found.
+		Returns the cycle length -- 1 for a fixed point, more than 1 for an oscillating circuit,
+		or 0 if neither was found within the limit.
+	*/
+	uint16_t settle (const uint16_t &limit);
+
+	/* uint16_t get_cycle (void)
+		Returns the cycle length found by the last wind_clock() or settle(), same as settle().
+	*/
+	uint16_t get_cycle (void);
+
+
+	/* ========== Cycle Detection ==========
+		Building blocks for wind_clock() and settle(), shared with BatchCellArray.
+	*/
+
+	/* uint64_t state_hash (void)
+		Returns a 64-bit hash of every cell output register.
+	*/
+	uint64_t state_hash (void);
+
+	/* void save_state (const uint64_t &hash)
+		Keeps a copy of the current cell outputs, along with their hash.
+	*/
+	void save_state (const uint64_t &hash);
+
+	/* bool is_saved_state (const uint64_t &hash)
+		Returns 1 if the current cell outputs are the same as the saved copy.
+	*/
+	bool is_saved_state (const uint64_t &hash);
+
+};
+
+
+
+/* Notes on the Batched Logical Cell Array
+	Same Cell Array model as LogicCellArray, for LCA_BATCH independent Cell Arrays at once.
+	Each row is a vector of LCA_BATCH words, word k being the row of 'lane' k.
+	Every lane has its own cell RAM, used for evaluating several individuals together.
+
+	Built with GCC vector extensions, 4 lanes on every machine -- The same lanes give the same scores.
+	clock() and state_hash() are built twice, the CPU picks one at run time:
+		AVX2    -- One 256-bit register per row
+		Others  -- Split into pairs of 128-bit registers (SSE2 / NEON)
+
+	Same next state equation, applied to every lane with a single vector operation:
+		next = (pass_a & in0) | (pass_b & in1) | (nand & ~(in0 & in1))
+
+	Cycle detection works on all lanes together, as one larger state machine.
+	The cycle length of the batch is the least common multiple of each lane's cycle length,
+	get_unstable() tells which lanes are still changing -- the oscillating ones.
+
+	Lanes are separate grids, not separate truth table rows of one grid.
+	A word already holds 64 cells of a row; slicing the other way, one word per cell and
+	one bit per truth table row, does the same work per clock over irregular neighbours,
+	and every row still has to wait for the one before it. Loop-free circuits skip the Cell Array
+	altogether, every row at once on the netlist (net.hpp).
+*/
+
+// Number of lanes of the Batched Logical Cell Array
+#define LCA_BATCH 4
+
+// One row of every lane -- Word k is the row of lane k
+typedef uint64_t lca_vec_t __attribute__ ((vector_size (LCA_BATCH * sizeof (uint64_t))));
+
+class BatchCellArray {
+
+private:
+
+	/* ========== Properties ========== */
+
+	// Pre-decoded Cell RAM -- One vector per row, one word per lane
+	lca_vec_t pass_a [PHYSICAL_DIMY];
+	lca_vec_t pass_b [PHYSICAL_DIMY];
+	lca_vec_t nand [PHYSICAL_DIMY];
+
+	// Cell Output Registers -- One vector per row, one word per lane
+	lca_vec_t state [PHYSICAL_DIMY];
+
+	// Linux Input Register -- Same value in every lane
+	lca_vec_t linux_in;
+
+	// Cells changed by the last clock -- OR of every row, one word per lane
+	lca_vec_t change;
+
+	// Cycle Detection -- See LogicCellArray
+	lca_vec_t saved [PHYSICAL_DIMY];
+	uint64_t saved_hash;
+	uint16_t cycle;
+
+	// Number of rows simulated, from the top -- Deepest cone of every lane
+	uint32_t depth;
+
+public:
+
+	/* ========== Constructors ========== */
+
+	/* Default Constructor
+		All RAM and registers of every lane set to zero.
+	*/
+	BatchCellArray (void);
+
+	/* void reset (void)
+		Resets every lane. Clears all cell RAM, cell outputs, and Linux input.
+	*/
+	void reset (void);
+
+
+	/* ========== Cell RAM ========== */
+
+	/* void set_image (const unsigned int &lane, const uint32_t *const image)
+		Sets the RAM of every cell of 'lane', from a packed grid (global.hpp).
+		Same as ram_write() of every word. A NULL image clears the RAM of the lane instead.
+	*/
+	void set_image (const unsigned int &lane, const uint32_t *const image);
+
+	/* void set_cone (const uint64_t &mask)
+		Same as LogicCellArray::set_cone(), for every lane.
+		Lasts until the next set_image() or reset().
+	*/
+	void set_cone (const uint64_t &mask);
+
+
+	/* ========== Input / Output ========== */
+
+	/* void set_input (const uint64_t &data)
+		Sets the Linux input register of every lane. Takes effect on the next clock.
+	*/
+	void set_input (const uint64_t &data);
+
+	/* uint64_t get_output (const unsigned int &lane)
+		Returns the current output of the top-most row (Row 0) of 'lane'.
+	*/
+	uint64_t get_output (const unsigned int &lane);
+
+
+	/* ========== Clock ========== */
+
+	/* bool clock (void)
+		Advances every lane by a single clock cycle.
+		Returns 1 if any cell output of any lane has changed.
+	*/
+	bool clock (void);
+
+	/* void wind_clock (const uint16_t &cycles)
+		Same as LogicCellArray::wind_clock(); delivers (cycles - 1) clock pulses to every lane.
+	*/
+	void wind_clock (const uint16_t &cycles);
+
+	/* uint16_t settle (const uint16_t &limit)
+		Same as LogicCellArray::settle(), for all lanes together.
+	*/
+	uint16_t settle (const uint16_t &limit);
+
+	/* uint16_t get_cycle (void)
+		Same as LogicCellArray::get_cycle(), for all lanes together.
+	*/
+	uint16_t get_cycle (void);
+
+	/* bool get_unstable (const unsigned int &lane)
+		Returns 1 if any cell output of 'lane' has changed on the last clock.
+		After settle(), these are the lanes stuck in a limit cycle.
+	*/
+	bool get_unstable (const unsigned int &lane);
+
+
+	/* ========== Cycle Detection ==========
+		Same as LogicCellArray, over every lane.
+	*/
+
+	uint64_t state_hash (void);
+
+	void save_state (const uint64_t &hash);
+
+	bool is_saved_state (const uint64_t &hash);
+
+};
+
+#endif
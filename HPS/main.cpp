@@ -18,6 +18,7 @@
 
 #include "main.hpp"		// Standard Includes & Function Prototypes
 #include "ansi.hpp"		// Colored Terminal Outputs
+#include "backend.hpp"	// Evaluation Backends
 #include "ca.hpp"		// Cellular Automaton Functions
 #include "eval.hpp"		// Evaluation Functions
 #include "fast.hpp"		// Initialize RNG Seed
@@ -224,12 +225,29 @@ void settings (void) {
 			ANSI_BOLD "\t===== Truth Table Parameters =====\n" ANSI_RESET
 			"\t12. TT Row Count\t| Current Value: %u\n"
 			"\t13. TT Mode (0 Combinational | 1 Sequential) | Current Value: %u\n"
-			"\t14. TT Mask\t\t| Current Value: %016llX | (%llu bits)\n\n"
+			"\t14. TT Mask\t\t| Current Value: %016llX | (%llu bits)\n"
+			ANSI_BOLD "\t===== Evaluation Parameters =====\n" ANSI_RESET
+			"\t15. EVAL Settle (0 Random Wait | 1 Until Stable) | Current Value: %u\n"
+			"\t16. EVAL Backend (0 Software | 1 FPGA | 2 Mock) | Current Value: %u\n"
+			"\t17. EVAL Wait (0 Sleep | 1 Spin | 2 Poll) | Current Value: %u\n"
+			ANSI_BOLD "\t===== Simulation Parameters =====\n" ANSI_RESET
+			"\t18. SIM Threads (Breeding, Software Evaluation) | Current Value: %u\n"
+			"\t19. SIM Seed (0 Current Time)\t| Current Value: %u\n"
+			"\t20. SIM Fitness Cache\t\t| Current Value: %u\n"
+			ANSI_BOLD "\t===== Mock Device Parameters =====\n" ANSI_RESET
+			"\t21. MOCK Read Latency (ns)\t| Current Value: %u\n"
+			"\t22. MOCK Write Latency (ns)\t| Current Value: %u\n"
+			ANSI_BOLD "\t===== Genetic Algorithm Operators =====\n" ANSI_RESET
+			"\t23. GA Crossover (0 Uniform | 1 One Point | 2 Two Point | 3 Rule Block) | Current Value: %u\n\n"
 			"Waiting for Input: ",
 			get_ga_pop(), get_ga_gen(), get_ga_mutp(), get_ga_pool(),
 			get_ca_dimx(), get_ca_dimy(), get_ca_color(), get_ca_nb(),
 			get_data_caprint(), get_data_export(), get_data_report(),
-			tt::get_row(), tt::get_mode(), tt::get_mask(), tt::get_mask_bc()
+			tt::get_row(), tt::get_mode(), tt::get_mask(), tt::get_mask_bc(),
+			get_eval_settle(), get_eval_backend(), get_eval_wait(),
+			get_sim_threads(), get_sim_seed(), get_sim_memo(),
+			get_mock_read(), get_mock_write(),
+			get_ga_cross()
 		);
 
 		// Sanitized Scan
@@ -314,6 +332,58 @@ void settings (void) {
 				tt::set_mask ( scan_hex () );
 				break;
 
+			case 15: // EVAL.SETTLE
+				printf ("Input New Value: ");
+				set_eval_settle ( scan_bool () );
+				break;
+
+			case 16: // EVAL.BACKEND
+				printf ("Input New Value: ");
+				set_eval_backend ( scan_uint () );
+				// Maps the FPGA or the mock device, as selected
+				fpga_init ();
+				break;
+
+			case 17: // EVAL.WAIT
+				printf ("Input New Value: ");
+				set_eval_wait ( scan_uint () );
+				// Recalibrates the wait, see fpga_wind_clock()
+				fpga_init ();
+				break;
+
+			case 18: // SIM.THREADS
+				printf ("Input New Value: ");
+				set_sim_threads ( scan_uint () );
+				break;
+
+			case 19: // SIM.SEED
+				printf ("Input New Value: ");
+				set_sim_seed ( scan_uint () );
+				break;
+
+			case 20: // SIM.MEMO
+				printf ("Input New Value: ");
+				set_sim_memo ( scan_bool () );
+				break;
+
+			case 21: // MOCK.READ
+				printf ("Input New Value: ");
+				set_mock_read ( scan_uint () );
+				// Restarts the mock device with the new latency
+				if ( fpga_is_mock () ) fpga_init ();
+				break;
+
+			case 22: // MOCK.WRITE
+				printf ("Input New Value: ");
+				set_mock_write ( scan_uint () );
+				if ( fpga_is_mock () ) fpga_init ();
+				break;
+
+			case 23: // GA.CROSS
+				printf ("Input New Value: ");
+				set_ga_cross ( scan_uint () );
+				break;
+
 			default:
 				printf ("Invalid input: %d\n", var);
 				break;
@@ -586,7 +656,7 @@ void inspect (void) {
 		printf (ANSI_YELLOW "No truth table defined.\n" ANSI_RESET);
 		goto INSPECT_END;
 	}
-	if ( fpga_is_init () == 0 ) {
+	if ( get_eval_backend () != BACKEND_SOFT && fpga_is_init () == 0 ) {
 		printf (ANSI_YELLOW "FPGA not initialized.\n" ANSI_RESET);
 		goto INSPECT_END;
 	}
@@ -597,10 +667,13 @@ void inspect (void) {
 		// How many test cases to run
 		constexpr unsigned int CHECK_NUM = 100;
 
-		fpga_clear ();
 		ca_gen_grid (grid, dna, seed);
 		ca_gen_grid (grid, dna);
-		fpga_set_grid (grid);
+
+		// Packed once, loaded for every test
+		uint32_t image [PACKED_SIZE];
+		ca_pack_grid (grid, image);
+		eval_load (image);
 
 		// Evaluate Circuit
 		const unsigned int max_score = get_score_max() * CHECK_NUM;
@@ -610,18 +683,15 @@ void inspect (void) {
 
 			// Check each case independently
 			eval_com_insp (0);
-			fpga_clear ();
-			fpga_set_grid (grid);
+			eval_load (image);
 			eval_com_insp (1);
-			fpga_clear ();
-			fpga_set_grid (grid);
+			eval_load (image);
 			eval_com_insp (2);
 
 			// Check random cases
 			printf ("\n\tChecking %u Random Cases... ", CHECK_NUM);
 
-			fpga_clear ();
-			fpga_set_grid (grid);
+			eval_load (image);
 			for (unsigned int i = 0 ; i < CHECK_NUM ; i++) {
 				score += eval_com (2);
 			}
@@ -633,8 +703,7 @@ void inspect (void) {
 			// Run continuous test
 			printf ("\n\tChecking %u Iterations... ", CHECK_NUM);
 
-			fpga_clear ();
-			fpga_set_grid (grid);
+			eval_load (image);
 			for (unsigned int i = 0 ; i < CHECK_NUM ; i++) {
 				score += eval_seq ();
 			}
@@ -655,7 +724,7 @@ void inspect (void) {
 
 	INSPECT_END:
 	delete[] dna;
-	fpga_clear ();
+	backend_get()->clear ();
 	return;
 }
 
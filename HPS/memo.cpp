@@ -0,0 +1,200 @@
+/* Main C++ File for the Fitness Cache
+	Repo: https://github.com/mimocha/ga-logic-circuit
+	Copyright (c) 2018 Chawit Leosrisook
+*/
+
+/* ========== Standard Library Include ========== */
+
+#include <stdio.h>		// printf
+#include <stdlib.h>		// calloc, free
+#include <stdint.h>		// uint definitions
+#include <string.h>		// memset, memcpy
+
+
+
+/* ========== Custom Header Include ========== */
+
+#include "memo.hpp"
+#include "ansi.hpp"
+#include "global.hpp"
+#include "truth.hpp"
+
+
+
+namespace tt = TruthTable;
+
+
+
+/* ========== Cache Variables ========== */
+
+// A single entry -- 16 bytes
+struct memo_entry {
+	uint64_t key;
+	uint32_t fit;
+	uint16_t gate;
+	bool sol;
+};
+
+// Hash table, NULL when disabled
+static memo_entry *table = NULL;
+
+// Identity of the seed row and truth table -- See memo_start()
+static uint64_t salt = 0;
+
+// Counters since memo_start()
+struct memo_stats {
+	uint32_t lookups;
+	uint32_t hits;
+	uint32_t stores;
+	uint32_t evictions;
+};
+
+static memo_stats count;
+
+
+
+/* ========== Hash Functions ========== */
+
+/* static uint64_t memo_hash (uint64_t hash, const void *const data, const size_t &bytes)
+	Mixes 'bytes' bytes of 'data' into 'hash', 8 bytes at a time.
+*/
+static uint64_t memo_hash (uint64_t hash, const void *const data, const size_t &bytes) {
+	const uint8_t *const byte = (const uint8_t *) data;
+
+	for (size_t i = 0 ; i < bytes ; i += 8) {
+		uint64_t word = 0;
+		memcpy (&word, byte + i, (bytes - i < 8) ? (bytes - i) : 8);
+
+		hash = (hash ^ word) * 0x9E3779B97F4A7C15ULL;
+		hash ^= hash >> 32;
+	}
+
+	return hash;
+}
+
+/* static uint64_t memo_key (const uint8_t *const dna, const uint32_t &dna_length)
+	Key of 'dna' under the current salt. Finalized with the SplitMix64 mixer, never 0.
+*/
+static uint64_t memo_key (const uint8_t *const dna, const uint32_t &dna_length) {
+	uint64_t key = memo_hash (salt ^ dna_length, dna, dna_length);
+
+	key ^= key >> 30;
+	key *= 0xBF58476D1CE4E5B9ULL;
+	key ^= key >> 27;
+	key *= 0x94D049BB133111EBULL;
+	key ^= key >> 31;
+
+	return (key == 0) ? 1 : key;
+}
+
+
+
+/* ========== Cache Functions ========== */
+
+bool memo_init (void) {
+	if ( GlobalSettings::get_sim_memo () == 0 ) {
+		memo_cleanup ();
+		return 1;
+	}
+
+	if (table == NULL) {
+		table = (memo_entry *) calloc (MEMO_SIZE, sizeof (memo_entry));
+
+		if (table == NULL) {
+			printf (ANSI_RED "Fitness cache allocation failed, continuing without it.\n" ANSI_RESET);
+			return 0;
+		}
+	} else {
+		memset (table, 0, MEMO_SIZE * sizeof (memo_entry));
+	}
+
+	return 1;
+}
+
+void memo_cleanup (void) {
+	free (table);
+	table = NULL;
+}
+
+void memo_start (const uint8_t *const seed) {
+	using namespace GlobalSettings;
+
+	const uint32_t dim [4] = { get_ca_dimx (), get_ca_dimy (), get_ca_color (), get_ca_nb () };
+	const uint64_t tt_mode = tt::get_mode ();
+	const uint64_t tt_mask = tt::get_mask ();
+	const size_t tt_bytes = tt::get_row () * sizeof (uint64_t);
+
+	uint64_t hash = 0;
+	hash = memo_hash (hash, dim, sizeof (dim));
+	hash = memo_hash (hash, seed, dim [0]);
+	hash = memo_hash (hash, &tt_mode, sizeof (tt_mode));
+	hash = memo_hash (hash, &tt_mask, sizeof (tt_mask));
+	hash = memo_hash (hash, tt::get_input (), tt_bytes);
+	hash = memo_hash (hash, tt::get_output (), tt_bytes);
+	salt = hash;
+
+	memset (&count, 0, sizeof (count));
+}
+
+bool memo_find (const uint8_t *const dna, const uint32_t &dna_length,
+uint32_t &fit, uint16_t &gate, bool &sol) {
+	if (table == NULL) return 0;
+
+	const uint64_t key = memo_key (dna, dna_length);
+	__atomic_add_fetch (&count.lookups, 1, __ATOMIC_RELAXED);
+
+	for (unsigned int p = 0 ; p < MEMO_PROBE ; p++) {
+		const memo_entry &entry = table [(key + p) & (MEMO_SIZE - 1)];
+
+		// Empty slot -- Nothing was ever stored further down
+		if (entry.key == 0) return 0;
+
+		if (entry.key == key) {
+			fit = entry.fit;
+			gate = entry.gate;
+			sol = entry.sol;
+			__atomic_add_fetch (&count.hits, 1, __ATOMIC_RELAXED);
+			return 1;
+		}
+	}
+
+	return 0;
+}
+
+void memo_store (const uint8_t *const dna, const uint32_t &dna_length,
+const uint32_t &fit, const uint16_t &gate, const bool &sol) {
+	if (table == NULL) return;
+
+	const uint64_t key = memo_key (dna, dna_length);
+	memo_entry *slot = NULL;
+
+	// Same key, or the first empty slot
+	for (unsigned int p = 0 ; p < MEMO_PROBE ; p++) {
+		memo_entry &entry = table [(key + p) & (MEMO_SIZE - 1)];
+
+		if (entry.key == key || entry.key == 0) {
+			slot = &entry;
+			break;
+		}
+	}
+
+	// Every probed slot taken -- Replaces the first one
+	if (slot == NULL) {
+		slot = &table [key & (MEMO_SIZE - 1)];
+		count.evictions++;
+	}
+
+	slot->key = key;
+	slot->fit = fit;
+	slot->gate = gate;
+	slot->sol = sol;
+	count.stores++;
+}
+
+void memo_report (void) {
+	if (table == NULL) return;
+
+	printf ("\tFitness Cache: %u lookups | %u hits | %5.2f%% hit rate | %u stored | %u replaced\n",
+		count.lookups, count.hits, (count.lookups > 0) ? (100.0 * count.hits / count.lookups) : 0.0,
+		count.stores, count.evictions );
+}
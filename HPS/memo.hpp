@@ -0,0 +1,75 @@
+/* Header File for the Fitness Cache
+	Repo: https://github.com/mimocha/ga-logic-circuit
+	Copyright (c) 2018 Chawit Leosrisook
+*/
+
+#ifndef MEMO_HPP
+#define MEMO_HPP
+
+/* Notes on the Fitness Cache
+	Crossover and mutation often breed a child with the exact DNA of an individual already scored,
+	its parent most of the time. The same DNA, grown from the same seed, is the same circuit,
+	so its scores are simply looked up instead -- Skipping both the CA generation and the evaluation.
+
+	Fixed-size, open-addressed hash table of MEMO_SIZE entries, linear probing up to MEMO_PROBE slots.
+	Each entry holds the fitness, efficiency, and solution flag of one DNA, under a 64-bit key:
+
+		key = hash (DNA, salt) | salt = hash (seed row, truth table, CA dimensions)
+
+	The full key is compared, the DNA itself is not kept. Two different DNA sharing a key is
+	unlikely enough (2^-64) to be ignored. Key 0 marks an empty entry.
+	When every probed slot is taken, the first one is replaced.
+
+	The table is cleared by memo_init(), as the evaluation settings are not part of the key.
+	memo_find() may be called from several threads at once, the breeding threads of Repopulate().
+	Everything else is only used by the main thread, never while memo_find() runs, see sim_run().
+*/
+
+// Number of entries -- 2^MEMO_BITS, 16 bytes each
+#define MEMO_BITS 16
+#define MEMO_SIZE (1 << MEMO_BITS)
+
+// Slots probed per lookup
+#define MEMO_PROBE 8
+
+/* bool memo_init (void)
+	Allocates the table, if needed, and clears it. Only allocated if "SIM Fitness Cache" is set,
+	otherwise the table is freed, and every lookup misses.
+	Returns 0 if the allocation failed, the cache is then disabled.
+*/
+bool memo_init (void);
+
+/* void memo_cleanup (void)
+	Frees the table.
+*/
+void memo_cleanup (void);
+
+/* void memo_start (const uint8_t *const seed)
+	Sets the salt of every key to the identity of 'seed', the current truth table and CA dimensions.
+	Resets the counters of memo_report(). Used at the start of every simulation.
+*/
+void memo_start (const uint8_t *const seed);
+
+/* bool memo_find (const uint8_t *const dna, const uint32_t &dna_length,
+	uint32_t &fit, uint16_t &gate, bool &sol)
+
+	Looks up the scores of 'dna'. Returns 1 and writes them to 'fit', 'gate', and 'sol' if found.
+	Returns 0 and leaves them untouched otherwise.
+*/
+bool memo_find (const uint8_t *const dna, const uint32_t &dna_length,
+	uint32_t &fit, uint16_t &gate, bool &sol);
+
+/* void memo_store (const uint8_t *const dna, const uint32_t &dna_length,
+	const uint32_t &fit, const uint16_t &gate, const bool &sol)
+
+	Stores the scores of 'dna', replacing any previous scores of the same DNA.
+*/
+void memo_store (const uint8_t *const dna, const uint32_t &dna_length,
+	const uint32_t &fit, const uint16_t &gate, const bool &sol);
+
+/* void memo_report (void)
+	Prints the lookups, hit rate, and replaced entries since memo_start(). Does nothing if disabled.
+*/
+void memo_report (void);
+
+#endif
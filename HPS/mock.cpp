@@ -0,0 +1,217 @@
+/* Main C++ File for the Mock Avalon Device
+	Repo: https://github.com/mimocha/ga-logic-circuit
+	Copyright (c) 2018 Chawit Leosrisook
+*/
+
+/* ========== Standard Library Include ========== */
+
+#include <stdint.h>		// uint definitions
+#include <string.h>		// memset, strncpy
+#include <time.h>		// clock_gettime
+
+
+
+/* ========== Linux API Include ========== */
+
+#include <sys/mman.h>	// mmap, munmap
+#include <pthread.h>	// Device thread
+
+
+
+/* ========== Custom Header Include ========== */
+
+#include "global.hpp"
+#include "fpga.hpp"
+#include "lca.hpp"
+#include "mock.hpp"
+
+
+
+/* ========== Mock Define ========== */
+
+// Size of the mapped region -- Everything up to the end of the Version ROM
+#define MOCK_SPAN (VROM_ADDR + 0x1000)
+
+// Version ROM contents
+#define MOCK_VERSION "MOCK DEVICE"
+
+
+
+/* ========== Mock Variables ========== */
+
+// Base of the mapped bridge
+static char *mock_base = NULL;
+
+// Software Cell Array -- Stands in for the FPGA
+static LogicCellArray mock_lca;
+
+// RAM words already copied into the Cell Array
+static uint32_t ram_shadow [SRAM_RANGE];
+
+// Register latency, in nanoseconds -- Local copy of GlobalSettings
+static unsigned int read_ns;
+static unsigned int write_ns;
+
+/* Device Thread
+	'busy' is set when the clock is wound up, cleared once the device has finished running it.
+*/
+struct mock_device {
+	pthread_t thread;
+	bool busy;
+	bool quit;
+
+	pthread_mutex_t lock;
+	pthread_cond_t ring;
+	pthread_cond_t done;
+};
+
+static mock_device dev;
+
+
+
+/* ========== Device Thread ========== */
+
+/* static void device_clock (void)
+	Runs the clock wound up through S3, same as the FPGA would.
+*/
+static void device_clock (void) {
+	volatile uint32_t *const sio = (volatile uint32_t *) (mock_base + S_IO);
+	volatile uint32_t *const sram = (volatile uint32_t *) (mock_base + S_RAM);
+	volatile uint16_t *const sclk = (volatile uint16_t *) (mock_base + S_CLK);
+
+	// RAM -- Only the words changed since the last clock
+	for (uint32_t i = 0 ; i < SRAM_RANGE ; i++) {
+		const uint32_t word = sram [i];
+
+		if (word != ram_shadow [i]) {
+			mock_lca.ram_write (i, word);
+			ram_shadow [i] = word;
+		}
+	}
+
+	// Linux input, LSB word first
+	mock_lca.set_input ( ((uint64_t) sio [1] << 32) | sio [0] );
+
+	const uint16_t cycles = *sclk;
+	mock_lca.wind_clock (cycles);
+
+	// Status register -- Remaining clock count, same address as the count written
+	*sclk = 0;
+
+	// Linux output, right after the input words
+	const uint64_t output = mock_lca.get_output ();
+	sio [SIO_RANGE] = (uint32_t) output;
+	sio [SIO_RANGE + 1] = (uint32_t) (output >> 32);
+}
+
+/* static void *device_thread (void *arg)
+	Waits for the clock to be wound up, runs it, then signals it is done. Until mock_cleanup().
+*/
+static void *device_thread (void *arg) {
+	pthread_mutex_lock (&dev.lock);
+
+	while (true) {
+		while (dev.busy == 0 && dev.quit == 0) {
+			pthread_cond_wait (&dev.ring, &dev.lock);
+		}
+
+		if (dev.quit) break;
+
+		pthread_mutex_unlock (&dev.lock);
+		device_clock ();
+		pthread_mutex_lock (&dev.lock);
+
+		dev.busy = 0;
+		pthread_cond_broadcast (&dev.done);
+	}
+
+	pthread_mutex_unlock (&dev.lock);
+	return NULL;
+}
+
+
+
+/* ========== Mock Functions ========== */
+
+void *mock_init (void) {
+	if (mock_base != NULL) mock_cleanup ();
+
+	void *const base = mmap
+	(NULL, MOCK_SPAN, (PROT_READ | PROT_WRITE), (MAP_SHARED | MAP_ANONYMOUS), -1, 0);
+
+	if (base == MAP_FAILED) return NULL;
+
+	// Anonymous memory starts zeroed, same as the FPGA after a reset
+	mock_base = (char *) base;
+	mock_lca.reset ();
+	memset (ram_shadow, 0, sizeof (ram_shadow));
+
+	strncpy (mock_base + VROM_ADDR, MOCK_VERSION, VROM_RANGE - 1);
+
+	read_ns = GlobalSettings::get_mock_read ();
+	write_ns = GlobalSettings::get_mock_write ();
+
+	// Starts the device
+	dev.busy = 0;
+	dev.quit = 0;
+
+	pthread_mutex_init (&dev.lock, NULL);
+	pthread_cond_init (&dev.ring, NULL);
+	pthread_cond_init (&dev.done, NULL);
+
+	pthread_create (&dev.thread, NULL, device_thread, NULL);
+
+	return mock_base;
+}
+
+void mock_cleanup (void) {
+	if (mock_base == NULL) return;
+
+	// Stops the device, after the current clock
+	mock_wait ();
+
+	pthread_mutex_lock (&dev.lock);
+	dev.quit = 1;
+	pthread_cond_signal (&dev.ring);
+	pthread_mutex_unlock (&dev.lock);
+
+	pthread_join (dev.thread, NULL);
+
+	pthread_mutex_destroy (&dev.lock);
+	pthread_cond_destroy (&dev.ring);
+	pthread_cond_destroy (&dev.done);
+
+	munmap (mock_base, MOCK_SPAN);
+	mock_base = NULL;
+}
+
+void mock_access (const bool &write) {
+	const unsigned int ns = (write) ? write_ns : read_ns;
+	if (ns == 0) return;
+
+	// Spins -- usleep() is far too coarse for a bus access
+	timespec start, now;
+	clock_gettime (CLOCK_MONOTONIC, &start);
+
+	do {
+		clock_gettime (CLOCK_MONOTONIC, &now);
+	} while ( (now.tv_sec - start.tv_sec) * 1000000000LL + (now.tv_nsec - start.tv_nsec) < ns );
+}
+
+void mock_service (void) {
+	// A new clock written during the last one only starts after it -- See fpga_wind_clock()
+	mock_wait ();
+
+	pthread_mutex_lock (&dev.lock);
+	dev.busy = 1;
+	pthread_cond_signal (&dev.ring);
+	pthread_mutex_unlock (&dev.lock);
+}
+
+void mock_wait (void) {
+	pthread_mutex_lock (&dev.lock);
+	while (dev.busy) {
+		pthread_cond_wait (&dev.done, &dev.lock);
+	}
+	pthread_mutex_unlock (&dev.lock);
+}
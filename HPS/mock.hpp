@@ -0,0 +1,61 @@
+/* Header File for the Mock Avalon Device
+	Repo: https://github.com/mimocha/ga-logic-circuit
+	Copyright (c) 2018 Chawit Leosrisook
+*/
+
+#ifndef MOCK_HPP
+#define MOCK_HPP
+
+/* Notes on the Mock Avalon Device
+	Stands in for the Lightweight HPS-to-FPGA bridge, so the register-level code of fpga.cpp
+	can run without the DE0-nano-SoC. An anonymous shared memory region is mapped in place of
+	/dev/mem, with the same slave port offsets (fpga.hpp):
+
+		S1 (Linux IO)      -- Input words at S_IO, output words right after them
+		S2 (RAM)           -- 512 words at S_RAM, the packed grid format (global.hpp)
+		S3 (Wind-up Clock) -- Clock count at S_CLK, read back as the remaining count
+		Version ROM        -- "MOCK DEVICE" at VROM_ADDR
+
+	Writes to S1 and S2 are plain memory writes. The device itself is a separate thread,
+	running a software Cell Array (lca.hpp). Once the clock is wound up through S3,
+	the device copies the new RAM words and the input into its Cell Array, runs the clock,
+	and writes the output back to S1 -- Concurrently with the HPS, same as the FPGA.
+
+	Register Latency
+	Every register read / write through fpga.cpp spins for a configurable time,
+	"MOCK Read / Write Latency" in the settings, to model the cost of the Avalon bus.
+	Used to profile and tune the register I/O of fpga.cpp, before running it on the FPGA.
+	Both default to 0, no added cost.
+*/
+
+/* void *mock_init (void)
+	Maps the mock device and starts its thread, equivalent to a power-on reset of the FPGA.
+	Register latency is read from GlobalSettings, see mock_access().
+	Returns the base of the mapped bridge, or NULL if the mapping failed.
+*/
+void *mock_init (void);
+
+/* void mock_cleanup (void)
+	Stops the device thread, and unmaps the mock device.
+*/
+void mock_cleanup (void);
+
+/* void mock_access (const bool &write)
+	Models the bus latency of a single register access: spins for the read, or write latency.
+	Called by the primitive Avalon port functions of fpga.cpp.
+*/
+void mock_access (const bool &write);
+
+/* void mock_service (void)
+	Signals the device that the clock was wound up through S3. Called by fpga_s3_write().
+	Returns right away, the device runs the clock on its own thread.
+*/
+void mock_service (void);
+
+/* void mock_wait (void)
+	Waits until the device has finished running the clock, and updated its output.
+	Used by fpga_wind_clock(), in place of the FPGA's fixed wait.
+*/
+void mock_wait (void);
+
+#endif
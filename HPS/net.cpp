@@ -0,0 +1,371 @@
+/* Main C++ File for the Netlist Compiler
+	Repo: https://github.com/mimocha/ga-logic-circuit
+	Copyright (c) 2018 Chawit Leosrisook
+*/
+
+/* ========== Standard Library Include ========== */
+
+#include <stdint.h>		// uint definitions
+#include <string.h>		// memset
+
+
+
+/* ========== Custom Header Include ========== */
+
+#include "global.hpp"
+#include "lca.hpp"
+#include "net.hpp"
+
+
+
+/* ========== Netlist Define ========== */
+
+// Bottom-most Row Index
+#define LAST_ROW (PHYSICAL_DIMY - 1)
+
+// No signal / no register
+#define NET_NONE 0xFFFF
+
+
+
+// =====================================================
+// NETLIST CLASS METHODS
+// =====================================================
+
+/* ========== Constructors ========== */
+
+NetList::NetList (void) {
+	prog_len = 0;
+	reg_count = 0;
+	loop_count = 0;
+	out_mask = 0;
+	depth = 0;
+	sig_count = NET_GATE;
+	grid = NULL;
+
+	for (uint32_t x = 0 ; x < PHYSICAL_DIMX ; x++) {
+		out_sig [x] = NET_ZERO;
+	}
+
+	lane_count = 1;
+	lane_mask = 0x1;
+
+	memset (val, 0, sizeof (val));
+	val [NET_ONE] = ~(uint64_t) 0;
+}
+
+
+
+/* ========== Compiler ========== */
+
+void NetList::compile (const uint8_t *const *const grid, const uint64_t &mask) {
+	this->grid = grid;
+
+	prog_len = 0;
+	reg_count = 0;
+	loop_count = 0;
+	sig_count = NET_GATE;
+	depth = 0;
+
+	memset (cell_depth, 0, sizeof (cell_depth));
+	memset (cell_reg, 0xFF, sizeof (cell_reg));
+	memset (inverse, 0xFF, sizeof (inverse));
+
+	// Constants are the inverse of each other
+	inverse [NET_ZERO] = NET_ONE;
+	inverse [NET_ONE] = NET_ZERO;
+
+	// Cells to compile -- Every masked output, and everything they depend on
+	out_mask = mask;
+	lca_cone (grid, mask, cell_wait);
+
+	/* Sweeps the rows from the bottom-most up, compiling each cell once the cells it reads are.
+		Cells only read the row below, a sweep compiles every cell up to the wrap-around.
+		A sweep compiling nothing is stuck on a feedback loop through the wrap-around.
+	*/
+	bool waiting = 1;
+
+	while (waiting) {
+		bool progress = 0;
+		waiting = 0;
+
+		for (int32_t y = LAST_ROW ; y >= 0 ; y--) {
+			uint64_t left = cell_wait [y];
+
+			while (left) {
+				const uint32_t x = __builtin_ctzll (left);
+				left &= left - 1;
+
+				if ( resolve (y, x) ) progress = 1;
+			}
+
+			if (cell_wait [y] != 0) waiting = 1;
+		}
+
+		if (waiting && progress == 0) break_loop ();
+	}
+
+	for (uint32_t x = 0 ; x < PHYSICAL_DIMX ; x++) {
+		if ( ((mask >> x) & 0x1) == 0 ) {
+			out_sig [x] = NET_ZERO;
+			continue;
+		}
+
+		out_sig [x] = cell_sig [0][x];
+		if (cell_depth [0][x] > depth) depth = cell_depth [0][x];
+	}
+
+	eliminate ();
+	reset ();
+}
+
+bool NetList::resolve (const uint32_t &y, const uint32_t &x) {
+	const uint8_t ram = grid [y][x] & 0x3;
+
+	uint16_t in0 = NET_ZERO;
+	uint16_t in1 = NET_ZERO;
+	uint32_t d0 = 0;
+	uint32_t d1 = 0;
+
+	// Input 0 -- Next row, same column. The bottom-most row reads the Linux input instead.
+	if (ram & 0x1) {
+		if (y < LAST_ROW) {
+			if ( (cell_wait [y+1] >> x) & 0x1 ) return 0;
+
+			in0 = cell_sig [y+1][x];
+			d0 = cell_depth [y+1][x];
+		} else {
+			in0 = NET_INPUT + x;
+		}
+	}
+
+	// Input 1 -- Next row, next column. The bottom-most row wraps around to the top-most row.
+	if (ram & 0x2) {
+		const uint32_t y1 = (y < LAST_ROW) ? (y + 1) : 0;
+		const uint32_t x1 = (x + 1) % PHYSICAL_DIMX;
+
+		if ( ((cell_wait [y1] >> x1) & 0x1) == 0 ) {
+			in1 = cell_sig [y1][x1];
+			d1 = cell_depth [y1][x1];
+		} else if (cell_reg [y1][x1] != NET_NONE) {
+			// Register of a loop -- The cell's value from the previous pass, no delay
+			in1 = reg_sig [cell_reg [y1][x1]];
+		} else {
+			return 0;
+		}
+	}
+
+	uint16_t sig;
+
+	switch (ram) {
+		case 0: sig = NET_ZERO; break;			// Constant
+		case 1: sig = in0; break;				// Wire, alias of Input 0
+		case 2: sig = in1; break;				// Wire, alias of Input 1
+		default: sig = emit_nand (in0, in1);	// NAND
+	}
+
+	// Every cell is a register on the Cell Array, one more clock cycle after its inputs
+	cell_depth [y][x] = 1 + ((d0 > d1) ? d0 : d1);
+	cell_sig [y][x] = sig;
+	cell_wait [y] &= ~((uint64_t) 1 << x);
+
+	// Closes the loop broken by this cell's register
+	if (cell_reg [y][x] != NET_NONE) {
+		reg_src [cell_reg [y][x]] = sig;
+	}
+
+	return 1;
+}
+
+void NetList::break_loop (void) {
+	// A bottom-most row cell, waiting on a top-most row cell -- Every stuck chain of cells ends with one
+	uint64_t stuck = cell_wait [LAST_ROW];
+
+	while (stuck) {
+		const uint32_t x = __builtin_ctzll (stuck);
+		const uint32_t x1 = (x + 1) % PHYSICAL_DIMX;
+		stuck &= stuck - 1;
+
+		if ( (grid [LAST_ROW][x] & 0x2) == 0 ) continue;
+		if ( ((cell_wait [0] >> x1) & 0x1) == 0 || cell_reg [0][x1] != NET_NONE ) continue;
+
+		// Feedback loop -- Breaks it with a register, holding the cell's value from the previous pass
+		cell_reg [0][x1] = reg_count;
+		reg_sig [reg_count] = sig_count++;
+		reg_src [reg_count] = NET_ZERO;
+		reg_count++;
+		loop_count++;
+		return;
+	}
+}
+
+uint16_t NetList::emit_nand (const uint16_t &a, const uint16_t &b) {
+	// Constant inputs
+	if (a == NET_ZERO || b == NET_ZERO) return NET_ONE;
+	if (a == NET_ONE && b == NET_ONE) return NET_ZERO;
+	if (a == NET_ONE) return emit_nand (b, b);
+	if (b == NET_ONE) return emit_nand (a, a);
+
+	// NAND (x, NOT x) = 1
+	if (inverse [a] == b || inverse [b] == a) return NET_ONE;
+
+	// NOT (NOT x) = x
+	if (a == b && inverse [a] != NET_NONE) return inverse [a];
+
+	const uint16_t dst = sig_count++;
+
+	prog [prog_len].dst = dst;
+	prog [prog_len].a = a;
+	prog [prog_len].b = b;
+	prog_len++;
+
+	// Remembers NOT gates, both ways
+	if (a == b) {
+		inverse [dst] = a;
+		inverse [a] = dst;
+	}
+
+	return dst;
+}
+
+void NetList::eliminate (void) {
+	memset (live, 0, sizeof (live));
+
+	for (uint32_t x = 0 ; x < PHYSICAL_DIMX ; x++) {
+		live [out_sig [x]] = 1;
+	}
+
+	// Marks the inputs of live instructions, from the last to the first.
+	// Registers feed values back to earlier instructions -- Repeats until nothing new is marked.
+	bool grown = 1;
+
+	while (grown) {
+		grown = 0;
+
+		for (int32_t i = prog_len - 1 ; i >= 0 ; i--) {
+			if (live [prog [i].dst] == 0) continue;
+			live [prog [i].a] = 1;
+			live [prog [i].b] = 1;
+		}
+
+		for (uint32_t r = 0 ; r < reg_count ; r++) {
+			if (live [reg_sig [r]] == 1 && live [reg_src [r]] == 0) {
+				live [reg_src [r]] = 1;
+				grown = 1;
+			}
+		}
+	}
+
+	// Compacts the program and the registers
+	uint32_t n = 0;
+	for (uint32_t i = 0 ; i < prog_len ; i++) {
+		if (live [prog [i].dst]) prog [n++] = prog [i];
+	}
+	prog_len = n;
+
+	n = 0;
+	for (uint32_t r = 0 ; r < reg_count ; r++) {
+		if (live [reg_sig [r]]) {
+			reg_sig [n] = reg_sig [r];
+			reg_src [n] = reg_src [r];
+			n++;
+		}
+	}
+	reg_count = n;
+}
+
+uint32_t NetList::get_inst_count (void) {
+	return prog_len;
+}
+
+uint32_t NetList::get_reg_count (void) {
+	return reg_count;
+}
+
+uint32_t NetList::get_loop_count (void) {
+	return loop_count;
+}
+
+uint32_t NetList::get_depth (void) {
+	return depth;
+}
+
+
+
+/* ========== Evaluation ========== */
+
+void NetList::reset (void) {
+	for (uint32_t r = 0 ; r < reg_count ; r++) {
+		val [reg_sig [r]] = 0;
+	}
+}
+
+void NetList::run (void) {
+	for (uint32_t i = 0 ; i < prog_len ; i++) {
+		const net_inst &inst = prog [i];
+		val [inst.dst] = ~(val [inst.a] & val [inst.b]);
+	}
+}
+
+void NetList::set_input (const uint64_t *const input, const unsigned int &count) {
+	lane_count = (count > NET_LANES) ? NET_LANES : count;
+	lane_mask = (lane_count == NET_LANES) ? ~(uint64_t) 0 : (((uint64_t) 1 << lane_count) - 1);
+
+	// Transpose -- Bit x of input [k] becomes bit k of input signal x
+	for (uint32_t x = 0 ; x < PHYSICAL_DIMX ; x++) {
+		uint64_t slice = 0;
+
+		for (uint32_t k = 0 ; k < lane_count ; k++) {
+			slice |= ((input [k] >> x) & 0x1) << k;
+		}
+
+		val [NET_INPUT + x] = slice;
+	}
+}
+
+uint16_t NetList::settle (const uint16_t &limit) {
+	if (reg_count == 0) {
+		run ();
+		return 1;
+	}
+
+	for (uint16_t pass = 1 ; pass <= limit ; pass++) {
+		run ();
+
+		bool stable = 1;
+
+		for (uint32_t r = 0 ; r < reg_count ; r++) {
+			reg_next [r] = val [reg_src [r]];
+			if (reg_next [r] != val [reg_sig [r]]) stable = 0;
+		}
+
+		if (stable) return pass;
+
+		for (uint32_t r = 0 ; r < reg_count ; r++) {
+			val [reg_sig [r]] = reg_next [r];
+		}
+	}
+
+	return 0;
+}
+
+unsigned int NetList::count_correct (const uint64_t *const expect, const uint64_t &mask) {
+	unsigned int correct = 0;
+
+	for (uint32_t x = 0 ; x < PHYSICAL_DIMX ; x++) {
+		if ( ((mask >> x) & 0x1) == 0 ) continue;
+
+		// Transpose the expected output of cell x
+		uint64_t slice = 0;
+		for (uint32_t k = 0 ; k < lane_count ; k++) {
+			slice |= ((expect [k] >> x) & 0x1) << k;
+		}
+
+		// Outputs which were not compiled are constant zero
+		const uint64_t observed = ( (out_mask >> x) & 0x1 ) ? val [out_sig [x]] : 0;
+
+		correct += __builtin_popcountll ( ~(slice ^ observed) & lane_mask );
+	}
+
+	return correct;
+}
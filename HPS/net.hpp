@@ -0,0 +1,216 @@
+/* Header File for the Netlist Compiler
+	Repo: https://github.com/mimocha/ga-logic-circuit
+	Copyright (c) 2018 Chawit Leosrisook
+*/
+
+#ifndef NET_HPP
+#define NET_HPP
+
+/* Notes on the Netlist Compiler
+	Compiles a (PHYSICAL_DIMY x PHYSICAL_DIMX) grid into a short, topologically ordered list of
+	NAND instructions, the same simplifications as LogicAnalysis.java, done in C++:
+
+		Cone     -- Only cells in the cone of influence of the masked outputs are compiled (lca.hpp)
+		Constant -- Cells with RAM 0 are constant zero, and are propagated through the gates
+		Wire     -- Cells with RAM 1 / 2 become aliases of the wire they pass on
+		NAND     -- NAND gates with a constant, or twice the same input, are folded
+		            NAND (0, b) = 1 | NAND (1, b) = NOT b | NAND (a, a) = NOT a | NAND (a, NOT a) = 1
+		Loop     -- Feedback loops are broken with explicit registers
+
+	Only the cone of influence of the masked outputs is compiled (lca_cone), row by row,
+	from the bottom-most row up -- Each cell only reads the row below it, or wraps around.
+	No recursion, compiling runs on worker threads with small stacks.
+
+	A NOT gate is a NAND with both inputs the same, so every instruction is: dst = ~(a & b)
+
+	Unlike the Cell Array, the netlist has zero delay -- each pass settles every gate at once.
+	Registers hold the value of their loop from the previous pass, until nothing changes.
+
+	For a loop-free cone (no registers), the netlist result is exactly the fixed point
+	the Cell Array reaches, once every cell has been clocked at least 'depth' times.
+
+	Bit-parallel representation:
+	Each signal is a uint64_t, bit k belonging to 'lane' k, an independent copy of the netlist.
+	Up to 64 truth table rows are evaluated with a single pass, one row per lane.
+*/
+
+// Signal Index -- Constants, Linux input bits, then gate and register outputs
+#define NET_ZERO 0
+#define NET_ONE 1
+#define NET_INPUT 2
+#define NET_GATE (NET_INPUT + PHYSICAL_DIMX)
+
+// Maximum number of signals -- One gate and one register per cell, at most
+#define NET_MAX_SIGNAL (NET_GATE + 2 * PHYSICAL_DIMX * PHYSICAL_DIMY)
+
+// Maximum number of lanes
+#define NET_LANES 64
+
+// A single instruction -- dst = ~(a & b)
+struct net_inst {
+	uint16_t dst;
+	uint16_t a;
+	uint16_t b;
+};
+
+class NetList {
+
+private:
+
+	/* ========== Program ========== */
+
+	// Instructions, in topological order
+	net_inst prog [PHYSICAL_DIMX * PHYSICAL_DIMY];
+	uint32_t prog_len;
+
+	// Registers -- Value of 'reg_sig [i]' is replaced with 'reg_src [i]' after every pass
+	uint16_t reg_sig [PHYSICAL_DIMX * PHYSICAL_DIMY];
+	uint16_t reg_src [PHYSICAL_DIMX * PHYSICAL_DIMY];
+	uint32_t reg_count;
+
+	// Output signal of every top-most row cell, and which of them are compiled
+	uint16_t out_sig [PHYSICAL_DIMX];
+	uint64_t out_mask;
+
+	// Longest chain of cells from an input to an output -- Clock cycles for the Cell Array to settle
+	uint32_t depth;
+
+	// Number of signals in use
+	uint32_t sig_count;
+
+
+	/* ========== Signal Values ========== */
+
+	// One word per signal, one bit per lane
+	uint64_t val [NET_MAX_SIGNAL];
+
+	// Number of lanes in use, and their mask
+	unsigned int lane_count;
+	uint64_t lane_mask;
+
+	// Register values for the next pass -- See settle()
+	uint64_t reg_next [PHYSICAL_DIMX * PHYSICAL_DIMY];
+
+
+	/* ========== Compiler Working Memory ========== */
+
+	// Grid being compiled
+	const uint8_t *const *grid;
+
+	// Number of registers created, including those removed later by eliminate()
+	uint32_t loop_count;
+
+	// Cells of the cone not yet compiled, one word per row
+	uint64_t cell_wait [PHYSICAL_DIMY];
+
+	// Per cell -- Signal, depth, and register (if the cell closes a loop)
+	uint16_t cell_sig [PHYSICAL_DIMY][PHYSICAL_DIMX];
+	uint16_t cell_depth [PHYSICAL_DIMY][PHYSICAL_DIMX];
+	uint16_t cell_reg [PHYSICAL_DIMY][PHYSICAL_DIMX];
+
+	// Per signal -- The signal it is the inverse of, if any, and whether it reaches an output
+	uint16_t inverse [NET_MAX_SIGNAL];
+	bool live [NET_MAX_SIGNAL];
+
+
+	/* ========== Compiler Functions ========== */
+
+	/* bool resolve (const uint32_t &y, const uint32_t &x)
+		Compiles cell (y,x), if every cell it reads is already compiled, or holds a register.
+		Returns 0 and leaves the cell waiting otherwise.
+	*/
+	bool resolve (const uint32_t &y, const uint32_t &x);
+
+	/* void break_loop (void)
+		Adds a register to a top-most row cell, read by a waiting bottom-most row cell.
+		Called when no waiting cell can be compiled, every one of them is on, or behind, a feedback loop.
+	*/
+	void break_loop (void);
+
+	/* uint16_t emit_nand (const uint16_t &a, const uint16_t &b)
+		Emits an instruction for NAND (a, b), after folding constants and inverses.
+		Returns the resulting signal.
+	*/
+	uint16_t emit_nand (const uint16_t &a, const uint16_t &b);
+
+	/* void eliminate (void)
+		Removes the instructions and registers which do not reach any output.
+	*/
+	void eliminate (void);
+
+public:
+
+	/* ========== Constructors ========== */
+
+	/* Default Constructor
+		Empty program, every output is constant zero.
+	*/
+	NetList (void);
+
+
+	/* ========== Compiler ========== */
+
+	/* void compile (const uint8_t *const *const grid, const uint64_t &mask)
+		Compiles the cone of influence of the output bits in 'mask', from the given grid.
+		Output bits outside of 'mask' are left as constant zero.
+		Register values are reset to zero.
+	*/
+	void compile (const uint8_t *const *const grid, const uint64_t &mask);
+
+	/* uint32_t get_inst_count (void)
+		Returns the number of instructions (live gates) in the program.
+	*/
+	uint32_t get_inst_count (void);
+
+	/* uint32_t get_reg_count (void)
+		Returns the number of registers -- 0 if the compiled cone has no loops.
+	*/
+	uint32_t get_reg_count (void);
+
+	/* uint32_t get_loop_count (void)
+		Returns the number of feedback loops found in the cone of influence,
+		including loops which were folded away, and do not reach any output.
+	*/
+	uint32_t get_loop_count (void);
+
+	/* uint32_t get_depth (void)
+		Returns the longest chain of cells, from an input to a compiled output.
+		The Cell Array needs this many clock cycles to settle, if the cone has no loops.
+	*/
+	uint32_t get_depth (void);
+
+
+	/* ========== Evaluation ========== */
+
+	/* void reset (void)
+		Sets every register of every lane to zero.
+	*/
+	void reset (void);
+
+	/* void run (void)
+		Runs the program once, a single pass over every instruction, for every lane.
+	*/
+	void run (void);
+
+	/* void set_input (const uint64_t *const input, const unsigned int &count)
+		Sets the Linux input of 'count' lanes, lane k gets 'input [k]'.
+		Transposes the given array into bit-slices. 'count' is limited to 64 lanes.
+	*/
+	void set_input (const uint64_t *const input, const unsigned int &count);
+
+	/* uint16_t settle (const uint16_t &limit)
+		Runs the program until no register changes, up to 'limit' passes.
+		Returns the number of passes, or 0 if the registers were still changing.
+		Without registers, a single pass is always enough.
+	*/
+	uint16_t settle (const uint16_t &limit);
+
+	/* unsigned int count_correct (const uint64_t *const expect, const uint64_t &mask)
+		Compares the output of each lane k, with 'expect [k]'.
+		Returns the number of matching output bits under 'mask', summed over all lanes in use.
+	*/
+	unsigned int count_correct (const uint64_t *const expect, const uint64_t &mask);
+
+};
+
+#endif
@@ -13,18 +13,23 @@
 #include <algorithm>	// sort, find
 #include <cstring>		// strcmp
 
+#include <pthread.h>	// Evaluation worker threads
+
 
 
 /* ========== Custom Header Include ========== */
 
 #include "sim.hpp"
 #include "ansi.hpp"
+#include "backend.hpp"
 #include "ca.hpp"
 #include "eval.hpp"
 #include "fast.hpp"
 #include "fpga.hpp"
 #include "ga.hpp"
 #include "global.hpp"
+#include "lca.hpp"
+#include "memo.hpp"
 #include "truth.hpp"
 
 
@@ -77,6 +82,65 @@ static stats_var stats_gate;
 
 
 
+/* ========== Worker Pool ========== */
+
+// Individuals per work unit of the pool -- See evaluate_batch()
+#define POOL_UNIT (4 * BACKEND_MAX_LANES)
+
+struct eval_pool {
+	// Worker threads
+	pthread_t thread [MAX_SIM_THREADS];
+	unsigned int workers;
+
+	// Task of the current round -- See pool_run()
+	ga_task *task;
+	void *arg;
+
+	// Round count, starts the workers -- Number of workers not yet done
+	unsigned int round;
+	unsigned int busy;
+	bool quit;
+
+	pthread_mutex_t lock;
+	pthread_cond_t wake;
+	pthread_cond_t done;
+};
+
+static eval_pool pool;
+
+
+
+/* ========== Evaluation Pipeline ========== */
+
+// Individuals queued ahead of the evaluation thread
+#define PIPE_DEPTH 16
+
+struct eval_pipe {
+	// Evaluation thread
+	pthread_t thread;
+	bool active;
+	bool quit;
+
+	// Ring of individuals -- 'head' is the next to be evaluated, 'count' not yet scored
+	unsigned int slot [PIPE_DEPTH];
+	unsigned int head;
+	unsigned int count;
+
+	pthread_mutex_t lock;
+	pthread_cond_t filled;
+	pthread_cond_t emptied;
+};
+
+static eval_pipe pipeline;
+
+/* Evaluation PRNG Key
+	Drawn from the main stream once per generation. Individual 'i' is evaluated with the stream
+	seeded with (eval_key + i), see eval_stream(), whichever thread evaluates it.
+*/
+static uint32_t eval_key;
+
+
+
 /* ========== Flags ========== */
 
 static bool solution_found = 0;
@@ -104,6 +168,35 @@ static void report (uint8_t *const *const grid, const uint8_t *const seed);
 
 static void data_dump (GeneticAlgorithm *const array, const unsigned int &gen);
 
+static const uint8_t *const *unpack (GeneticAlgorithm &target);
+
+static void assign_score (GeneticAlgorithm &target, const unsigned int &score);
+
+static void eval_stream (const unsigned int &index);
+
+static void evaluate_batch (void *const arg, const unsigned int &part, const unsigned int &parts);
+
+static void evaluate_queue (GeneticAlgorithm *const array, const uint32_t *const *const image,
+	const unsigned int *const index, unsigned int *const score, const unsigned int &count);
+
+static void *pool_worker (void *arg);
+
+static void pool_start (void);
+
+static void pool_stop (void);
+
+static void pool_run (ga_task *const task, void *const arg);
+
+static void *pipe_worker (void *arg);
+
+static void pipe_start (void);
+
+static void pipe_stop (void);
+
+static void pipe_push (const unsigned int &index);
+
+static void pipe_drain (void);
+
 
 
 /* ========== Miscellany Functions ========== */
@@ -142,6 +235,315 @@ void status_print (const unsigned int &gen) {
 
 
 
+/* ========== Evaluation ========== */
+
+const uint8_t *const *unpack (GeneticAlgorithm &target) {
+	// One grid per thread -- Valid until the next call
+	static thread_local uint8_t cells [PHYSICAL_DIMY][PHYSICAL_DIMX];
+	static thread_local uint8_t *rows [PHYSICAL_DIMY];
+
+	for (unsigned int y = 0 ; y < PHYSICAL_DIMY ; y++) {
+		rows [y] = cells [y];
+	}
+
+	ca_unpack_image (target.get_image(), rows);
+	return rows;
+}
+
+void assign_score (GeneticAlgorithm &target, const unsigned int &score) {
+	// Flags this as a viable solution, if the fitness is maxed
+	target.set_sol ((score == fit_lim));
+
+	// Assign fitness score
+	target.set_fit (score);
+	target.set_eval (1);
+}
+
+void eval_stream (const unsigned int &index) {
+	// Same individual, same random inputs and waits -- On any thread, with any number of threads
+	rng32 () = Xoshiro128ss (eval_key + index);
+}
+
+void evaluate_batch (void *const arg, const unsigned int &part, const unsigned int &parts) {
+	GeneticAlgorithm *const array = (GeneticAlgorithm *) arg;
+
+	// Individuals waiting for evaluation, up to one per lane of the backend
+	const unsigned int lanes = backend_get()->get_lanes ();
+	const uint32_t *image [BACKEND_MAX_LANES];
+	unsigned int index [BACKEND_MAX_LANES];
+	unsigned int score [BACKEND_MAX_LANES];
+	unsigned int count = 0;
+
+	// Only the software backend takes the netlist shortcut -- The devices evaluate every circuit
+	const bool shortcut = (get_eval_backend () == BACKEND_SOFT);
+
+	// Work units of this part -- Unit k belongs to part (k % parts)
+	for (unsigned int unit = part * POOL_UNIT ; unit < pop_lim ; unit += parts * POOL_UNIT) {
+		const unsigned int end = (unit + POOL_UNIT < pop_lim) ? (unit + POOL_UNIT) : pop_lim;
+
+		for (unsigned int i = unit ; i < end ; i++) {
+			// Scored already, or removed by Selection() -- Replaced by Repopulate()
+			if ( array[i].get_eval () != 0 || array[i].get_alive () == 0 ) continue;
+
+			// Evaluate Efficiency -- The backends run the packed circuit as is
+			const uint8_t *const *const grid = unpack (array[i]);
+			array[i].set_gate (eval_efficiency (grid));
+
+			// Loop-free circuits are evaluated exactly by their netlist, without the simulator
+			unsigned int net_score;
+
+			if ( shortcut && eval_net (grid, net_score) ) {
+				assign_score (array[i], net_score);
+				continue;
+			}
+
+			image [count] = array[i].get_image();
+			index [count] = i;
+			count++;
+
+			// Evaluates once the batch is full
+			if (count == lanes) {
+				evaluate_queue (array, image, index, score, count);
+				count = 0;
+			}
+		}
+
+		// Evaluates the rest of the unit -- Batches never span two units, nor two workers
+		if (count > 0) {
+			evaluate_queue (array, image, index, score, count);
+			count = 0;
+		}
+	}
+}
+
+void evaluate_queue (GeneticAlgorithm *const array, const uint32_t *const *const image,
+const unsigned int *const index, unsigned int *const score, const unsigned int &count) {
+	// Every lane of a batch shares the random inputs and waits -- The stream of its first individual
+	eval_stream (index [0]);
+	backend_get()->evaluate_table (image, count, score);
+
+	for (unsigned int k = 0 ; k < count ; k++) {
+		assign_score (array[index[k]], score[k]);
+	}
+}
+
+
+
+/* ========== Worker Pool ==========
+	The pool's worker threads run the parallel tasks of every generation, each with its own part:
+	breeding the offspring (see GeneticAlgorithm::Repopulate()), then evaluating them.
+	The threads are created once, when the simulation starts, see pool_run().
+	Every worker has its own simulators, see eval.cpp.
+
+	Batches of individuals are formed within a work unit, in index order, and each is evaluated
+	with the stream of its first individual, see eval_stream().
+	Scores do not depend on which worker evaluates a batch, nor on the number of workers,
+	so a fixed seed always gives the same simulation, with any "SIM Threads" setting.
+*/
+
+void *pool_worker (void *arg) {
+	const unsigned int part = (unsigned int) (uintptr_t) arg;
+	unsigned int round = 0;
+
+	while (true) {
+		// Waits for the next generation
+		pthread_mutex_lock (&pool.lock);
+		while (pool.round == round && pool.quit == 0) {
+			pthread_cond_wait (&pool.wake, &pool.lock);
+		}
+
+		if (pool.quit) {
+			pthread_mutex_unlock (&pool.lock);
+			return NULL;
+		}
+
+		round = pool.round;
+		pthread_mutex_unlock (&pool.lock);
+
+		pool.task (pool.arg, part, pool.workers);
+
+		// The last worker to finish wakes up the main thread
+		pthread_mutex_lock (&pool.lock);
+		pool.busy--;
+		if (pool.busy == 0) pthread_cond_signal (&pool.done);
+		pthread_mutex_unlock (&pool.lock);
+	}
+}
+
+void pool_start (void) {
+	// Breeding always runs on several threads, evaluating only with the software backend -- See backend.hpp
+	pool.workers = get_sim_threads ();
+	pool.round = 0;
+	pool.busy = 0;
+	pool.quit = 0;
+
+	// A single worker is the main thread itself -- See pool_run()
+	if (pool.workers <= 1) return;
+
+	pthread_mutex_init (&pool.lock, NULL);
+	pthread_cond_init (&pool.wake, NULL);
+	pthread_cond_init (&pool.done, NULL);
+
+	for (unsigned int w = 0 ; w < pool.workers ; w++) {
+		pthread_create (&pool.thread [w], NULL, pool_worker, (void *) (uintptr_t) w);
+	}
+}
+
+void pool_stop (void) {
+	if (pool.workers > 1) {
+		pthread_mutex_lock (&pool.lock);
+		pool.quit = 1;
+		pthread_cond_broadcast (&pool.wake);
+		pthread_mutex_unlock (&pool.lock);
+
+		for (unsigned int w = 0 ; w < pool.workers ; w++) {
+			pthread_join (pool.thread [w], NULL);
+		}
+
+		pthread_mutex_destroy (&pool.lock);
+		pthread_cond_destroy (&pool.wake);
+		pthread_cond_destroy (&pool.done);
+	}
+
+	pool.workers = 0;
+}
+
+void pool_run (ga_task *const task, void *const arg) {
+	// Tasks switch the thread's PRNG stream -- The main thread keeps its own
+	if (pool.workers <= 1) {
+		const Xoshiro128ss own = rng32 ();
+		task (arg, 0, 1);
+		rng32 () = own;
+		return;
+	}
+
+	// Starts every worker, then waits for all of them to finish
+	pthread_mutex_lock (&pool.lock);
+	pool.task = task;
+	pool.arg = arg;
+	pool.busy = pool.workers;
+	pool.round++;
+	pthread_cond_broadcast (&pool.wake);
+
+	while (pool.busy > 0) {
+		pthread_cond_wait (&pool.done, &pool.lock);
+	}
+	pthread_mutex_unlock (&pool.lock);
+}
+
+
+
+/* ========== Evaluation Pipeline ==========
+	Used with the FPGA and the mock device, in place of the pool.
+	The breeding threads queue each offspring as soon as its circuit is generated, see pipe_push().
+	Circuits are already in the S2 format, see ca_gen_image().
+	The queue holds population indices, not copies of the packed images: the evaluation thread
+	reads each image in place, from the individual, which the main thread leaves untouched
+	until it is scored.
+	The evaluation thread scores the gate efficiency, then streams the circuit and the test vectors
+	to the device, so the device keeps running during Repopulate(), instead of waiting for it.
+
+	Selection() and Sort() depend on every fitness score of the generation,
+	the queue is drained before them, see pipe_drain().
+*/
+
+void *pipe_worker (void *arg) {
+	Backend &dev = *backend_get ();
+
+	pthread_mutex_lock (&pipeline.lock);
+
+	while (true) {
+		while (pipeline.count == 0 && pipeline.quit == 0) {
+			pthread_cond_wait (&pipeline.filled, &pipeline.lock);
+		}
+
+		if (pipeline.count == 0) break;
+
+		// The individual stays untouched by the main thread until it is scored
+		const unsigned int index = pipeline.slot [pipeline.head];
+		pthread_mutex_unlock (&pipeline.lock);
+
+		const uint32_t *const image = indv[index].get_image();
+		unsigned int score;
+
+		// Evaluate Efficiency
+		const uint8_t *const *const grid = unpack (indv [index]);
+		indv[index].set_gate (eval_efficiency (grid));
+
+		// Loop-free circuits start from the previous outputs, the others from a cleared device
+		const bool settles = eval_settles (grid);
+
+		eval_stream (index);
+		eval_table (dev, &image, 1, &score, &settles);
+		assign_score (indv [index], score);
+
+		pthread_mutex_lock (&pipeline.lock);
+		pipeline.head = (pipeline.head + 1) % PIPE_DEPTH;
+		pipeline.count--;
+		pthread_cond_broadcast (&pipeline.emptied);
+	}
+
+	pthread_mutex_unlock (&pipeline.lock);
+	return NULL;
+}
+
+void pipe_start (void) {
+	// The software backend uses the pool instead -- See pool_start()
+	pipeline.active = (get_eval_backend () != BACKEND_SOFT);
+	if (pipeline.active == 0) return;
+
+	pipeline.quit = 0;
+	pipeline.head = 0;
+	pipeline.count = 0;
+
+	pthread_mutex_init (&pipeline.lock, NULL);
+	pthread_cond_init (&pipeline.filled, NULL);
+	pthread_cond_init (&pipeline.emptied, NULL);
+
+	pthread_create (&pipeline.thread, NULL, pipe_worker, NULL);
+}
+
+void pipe_stop (void) {
+	if (pipeline.active == 0) return;
+
+	// Finishes the queued images first
+	pthread_mutex_lock (&pipeline.lock);
+	pipeline.quit = 1;
+	pthread_cond_signal (&pipeline.filled);
+	pthread_mutex_unlock (&pipeline.lock);
+
+	pthread_join (pipeline.thread, NULL);
+
+	pthread_mutex_destroy (&pipeline.lock);
+	pthread_cond_destroy (&pipeline.filled);
+	pthread_cond_destroy (&pipeline.emptied);
+
+	pipeline.active = 0;
+}
+
+void pipe_push (const unsigned int &index) {
+	// Waits for a free slot
+	pthread_mutex_lock (&pipeline.lock);
+	while (pipeline.count == PIPE_DEPTH) {
+		pthread_cond_wait (&pipeline.emptied, &pipeline.lock);
+	}
+
+	pipeline.slot [(pipeline.head + pipeline.count) % PIPE_DEPTH] = index;
+	pipeline.count++;
+	pthread_cond_signal (&pipeline.filled);
+	pthread_mutex_unlock (&pipeline.lock);
+}
+
+void pipe_drain (void) {
+	pthread_mutex_lock (&pipeline.lock);
+	while (pipeline.count > 0) {
+		pthread_cond_wait (&pipeline.emptied, &pipeline.lock);
+	}
+	pthread_mutex_unlock (&pipeline.lock);
+}
+
+
+
 /* ========== Simulation Functions ========== */
 
 void sim_init (void) {
@@ -151,7 +553,7 @@ void sim_init (void) {
 		return;
 	}
 
-	if ( fpga_is_init () == 0 ) {
+	if ( get_eval_backend () != BACKEND_SOFT && fpga_is_init () == 0 ) {
 		printf (ANSI_RED "FPGA not initialized.\n" ANSI_RESET);
 		return;
 	}
@@ -171,11 +573,11 @@ void sim_init (void) {
 	dna_length = get_dna_length ();
 
 	printf (ANSI_REVRS "\n\t>>>-- Initializing Simulation --<<<\n" ANSI_RESET
-		"\tPOP = %4u | GEN = %4u | MUT = %0.3f | POOL = %4u\n"
+		"\tPOP = %4u | GEN = %4u | MUT = %0.3f | POOL = %4u | CROSS = %1u\n"
 		"\tDIMX = %3u | DIMY = %3u | COLOR = %3u | NEIGHBOR = %2u\n"
 		"\tCAPRINT = %1u | EXPORT = %1u | REPORT = %1u\n"
 		"\tROW = %1u | MODE : ",
-		pop_lim, gen_lim, get_ga_mutp(), get_ga_pool(),
+		pop_lim, gen_lim, get_ga_mutp(), get_ga_pool(), get_ga_cross(),
 		dimx, dimy, color, nb,
 		get_data_caprint(), get_data_export(), get_data_report(),
 		tt::get_row()
@@ -189,11 +591,22 @@ void sim_init (void) {
 
 	printf ("\tTT MASK = 0x%016llX (%llu bits)\n\n", tt::get_mask(), tt::get_mask_bc());
 
+	// Seed RNG -- Before the initial population is generated
+	if (get_sim_seed () == 0) {
+		seed_rng32 ();
+	} else {
+		seed_rng32 (get_sim_seed ());
+	}
+
 	/* Allocates an array of individuals (population)
 		new / delete unavailable for struct and classes
 		/lib/libstdc++.so.6: version `CXXABI_1.3.8' not found
 	*/
 	indv = (GeneticAlgorithm *) calloc (pop_lim, sizeof (GeneticAlgorithm));
+
+	// DNA and CA grid of every individual -- One slab for the whole population
+	GeneticAlgorithm::arena_alloc (pop_lim, dna_length);
+
 	for (unsigned int i = 0 ; i < pop_lim ; i++) {
 		indv [i] = GeneticAlgorithm (dna_length);
 	}
@@ -213,14 +626,18 @@ void sim_init (void) {
 	// Set fitness limit
 	fit_lim = get_score_max ();
 
-	// Seed RNG
-	seed_rng32 ();
+	// Clear the fitness cache -- Scores depend on settings not in its keys
+	memo_init ();
+
+	// Start the evaluation worker threads, or the pipeline
+	pool_start ();
+	pipe_start ();
 
 	// Calculate time estimate
 	time_est = ((float) gen_lim * pop_lim / INDV_PER_SEC);
 
-	// Clear FPGA LCA
-	fpga_clear ();
+	// Clear the backend Cell Array
+	backend_get()->clear ();
 
 	// Set Flags
 	data_exported = 0;
@@ -241,10 +658,14 @@ void sim_cleanup (void) {
 	sim_done = 0;
 	sim_init_flag = 0;
 
-	// Free GA Class Objects
-	for (unsigned int i = 0 ; i < pop_lim ; i++) {
-		indv[i].Free ();
-	}
+	// Stop the evaluation worker threads, and the pipeline
+	pool_stop ();
+	pipe_stop ();
+
+	memo_cleanup ();
+
+	// Free GA Class Objects -- DNA and CA grids all at once
+	GeneticAlgorithm::arena_free ();
 	free (indv);
 
 	// Free data array
@@ -272,6 +693,8 @@ int sim_run (uint8_t *const *const grid, const uint8_t *const seed) {
 
 	printf ("\tSimulation Progress:\n");
 	time (&time_start);
+	fpga_idle_reset ();
+	memo_start (seed);
 
 
 
@@ -279,54 +702,51 @@ int sim_run (uint8_t *const *const grid, const uint8_t *const seed) {
 
 	// Loop over each generation
 	for (unsigned int gen = 0 ; gen < gen_lim ; gen++) {
-		// Perform selection, reproduction, crossover, and mutation
-		GeneticAlgorithm::Selection (indv);
-		GeneticAlgorithm::Repopulate (indv, seed);
+		// Key of this generation's evaluation streams -- Before any individual is evaluated
+		eval_key = fast_rng32 ();
 
-		// Loop over each individual
-		for (unsigned int i = 0 ; i < pop_lim ; i++) {
-			// Automatically ages an individual
-			indv[i].set_age();
-
-			// Evaluate Individual -- Once per individual
-			if ( indv[i].get_eval () == 0 ) {
-				fpga_clear ();
+		// Perform selection
+		GeneticAlgorithm::Selection (indv);
 
-				// Edit FPGA RAM
-				fpga_set_grid (indv[i].get_grid());
+		// Survivors not yet evaluated (first generation) -- Parents need their fitness
+		unsigned int unscored = 0;
 
-				// Evaluate Circuit Truth Table
-				uint32_t score = 0;
+		for (unsigned int i = 0 ; i < pop_lim ; i++) {
+			if ( indv[i].get_alive () == 0 || indv[i].get_eval () != 0 ) continue;
 
-				// Sequential or Combinational Logic
-				if (tt::get_mode() == 0) {
-					// Test a few cases and gets the average score
-					score += eval_com (0);
-					score += eval_com (1);
+			unscored++;
+			if (pipeline.active) pipe_push (i);
+		}
 
-					for (int j = 0 ; j < 3 ; j++) {
-						score += eval_com (2);
-					}
+		if (pipeline.active) {
+			pipe_drain ();
+		} else if (unscored > 0) {
+			pool_run (evaluate_batch, indv);
+		}
 
-					score /= 5;
-				} else {
-					// Runs a single continuous test
-					score = eval_seq ();
-				}
+		// Perform reproduction, crossover, and mutation
+		// With the pipeline, offspring are evaluated as they are bred
+		GeneticAlgorithm::Repopulate (indv, seed, (pipeline.active) ? pipe_push : NULL, pool_run);
 
-				// Flags this as a viable solution, if the fitness is maxed
-				indv[i].set_sol ((score == fit_lim));
+		// Automatically ages every individual
+		for (unsigned int i = 0 ; i < pop_lim ; i++) {
+			indv[i].set_age();
+		}
 
-				// Assign fitness score
-				indv[i].set_fit (score);
+		// Evaluate Individuals -- Once per individual
+		if (pipeline.active) {
+			pipe_drain ();
+		} else {
+			pool_run (evaluate_batch, indv);
+		}
 
-				// Evaluate Efficiency
-				indv[i].set_gate (eval_efficiency (indv[i].get_grid()));
-				indv[i].set_eval (1);
-			}
+		// Remembers the scores of this generation's offspring, see memo.hpp
+		for (unsigned int i = 0 ; i < pop_lim ; i++) {
+			if ( indv[i].get_age () != 1 ) continue;
+			memo_store (indv[i].get_dna (), dna_length, indv[i].get_fit (), indv[i].get_gate (), indv[i].get_sol ());
 		}
 
-		// Sort population by fitness & solution
+		// Rank population by fitness & solution
 		// Descending order, solutions, higher fitness, higher efficiency first
 		GeneticAlgorithm::Sort (indv);
 
@@ -347,10 +767,15 @@ int sim_run (uint8_t *const *const grid, const uint8_t *const seed) {
 
 	// ===== END SIMULATION LOOP ===== //
 
+	// Time spent waiting on the FPGA / mock device
+	if ( get_eval_backend () != BACKEND_SOFT ) fpga_idle_report ();
+	GeneticAlgorithm::neutral_report ();
+	memo_report ();
+
 	if ( get_data_report() ) report (grid, seed);
 
 	sim_done = 1;
-	fpga_clear ();
+	backend_get()->clear ();
 	return solution_found;
 }
 
@@ -364,6 +789,8 @@ bool sim_is_done (void) {
 /* ========== Results & Reporting Function ========== */
 
 void statistics (GeneticAlgorithm *const array, const unsigned int &gen) {
+	// Array index of each rank -- The array itself is not sorted
+	const uint32_t *const rank = GeneticAlgorithm::get_rank ();
 
 	// ===== Fitness Score Statistics ===== //
 
@@ -376,20 +803,20 @@ void statistics (GeneticAlgorithm *const array, const unsigned int &gen) {
 		average /= pop_lim;
 		stats.avg [gen] = average;
 
-		// Median (list is presorted)
+		// Median (list is ranked)
 		float median = 0.0;
 		if (pop_lim % 2 == 0) {
-			median = array[pop_lim/2].get_fit() + array[(pop_lim/2)-1].get_fit();
+			median = array[rank[pop_lim/2]].get_fit() + array[rank[(pop_lim/2)-1]].get_fit();
 			stats.med [gen] = median/2;
 		} else {
-			stats.med [gen] = array[pop_lim/2].get_fit();
+			stats.med [gen] = array[rank[pop_lim/2]].get_fit();
 		}
 
-		// Max (list is presorted)
-		stats.max [gen] = array[0].get_fit();
+		// Max (list is ranked)
+		stats.max [gen] = array[rank[0]].get_fit();
 
-		// Min (list is presorted)
-		stats.min [gen] = array[pop_lim-1].get_fit();
+		// Min (list is ranked)
+		stats.min [gen] = array[rank[pop_lim-1]].get_fit();
 
 		// Check for solutions found
 		stats.sol_count [gen] = count_solution (array);
@@ -409,7 +836,7 @@ void statistics (GeneticAlgorithm *const array, const unsigned int &gen) {
 
 
 		// Max - Min - Median
-		int working_array [pop_lim] = {0};
+		int working_array [pop_lim];
 
 		for (uint32_t i=0; i<pop_lim; i++) {
 			unsigned short gate_val = array[i].get_gate();
@@ -463,11 +890,15 @@ void report (uint8_t *const *const grid, const uint8_t *const seed) {
 			stats.min [gen_lim-1], fit_lim
 	);
 
+	// Array index of each rank
+	const uint32_t *const rank = GeneticAlgorithm::get_rank ();
+	GeneticAlgorithm &best = indv [rank[0]];
+
 	// Displays top 'N' individuals
 	printf ("\nTop %u Individuals:\n", N);
 	for (unsigned int i = 0 ; i < N ; i++) {
-		printf ("[%1u] UID: %u | FIT: %u | DNA: ", i, indv[i].get_uid(), indv[i].get_fit() );
-		indv[i].print_dna( dna_length );
+		printf ("[%1u] UID: %u | FIT: %u | DNA: ", i, indv[rank[i]].get_uid(), indv[rank[i]].get_fit() );
+		indv[rank[i]].print_dna( dna_length );
 		printf ("\n");
 	}
 
@@ -475,26 +906,27 @@ void report (uint8_t *const *const grid, const uint8_t *const seed) {
 	// ===== Evaluate & Graph Top Individuals ===== //
 
 	printf ("\n\n\tFittest Individual:\n"
-		"UID: %u | FIT: %u | DNA: ", indv[0].get_uid(), indv[0].get_fit() );
-	indv[0].print_dna( dna_length );
+		"UID: %u | FIT: %u | DNA: ", best.get_uid(), best.get_fit() );
+	best.print_dna( dna_length );
 	printf ("\n");
 
 	// Generate & Set Grid
-	ca_gen_grid (grid, indv[0].get_dna(), seed);
-	ca_gen_grid (grid, indv[0].get_dna());
-	fpga_clear ();
-	fpga_set_grid (grid);
+	ca_gen_grid (grid, best.get_dna(), seed);
+	ca_gen_grid (grid, best.get_dna());
+
+	// Packed again -- A cached individual never had its own circuit generated
+	uint32_t image [PACKED_SIZE];
+	ca_pack_grid (grid, image);
+	eval_load (image);
 
 	// Evaluate Circuit
 	if ( tt::get_mode() == 0 ) {
 
 		// Check each case independently
 		eval_com_insp (0);
-		fpga_clear ();
-		fpga_set_grid (grid);
+		eval_load (image);
 		eval_com_insp (1);
-		fpga_clear ();
-		fpga_set_grid (grid);
+		eval_load (image);
 		eval_com_insp (2);
 
 	} else {
@@ -511,7 +943,7 @@ void report (uint8_t *const *const grid, const uint8_t *const seed) {
 		cout << endl;
 	}
 
-	fpga_clear ();
+	backend_get()->clear ();
 	return;
 }
 
@@ -567,6 +999,7 @@ void sim_export (void) {
 		"Population Limit: %u\n"
 		"Mutation Rate: %f\n"
 		"Tournament Pool Size: %u\n"
+		"Crossover Operator: %u\n"
 		"====== Cellular Automaton ======\n"
 		"X Dimension: %u\n"
 		"Y Dimension: %u\n"
@@ -577,7 +1010,7 @@ void sim_export (void) {
 		"MASK: 0x%016llX\n"
 		"MASK Bitcount: %llu\n"
 		"Mode: " ,
-		gen_lim, pop_lim, get_ga_mutp(), get_ga_pool(),
+		gen_lim, pop_lim, get_ga_mutp(), get_ga_pool(), get_ga_cross(),
 		dimx, dimy, color, nb,
 		tt::get_row(), tt::get_mask(), tt::get_mask_bc()
 	);
@@ -599,14 +1032,18 @@ void sim_export (void) {
 	fprintf (rpt, "\n\nPopulation Dump:\n"
 				"    UID | SOL | FITNESS | GATE | DNA \n");
 
-	// Prints N or the current pop size, which ever is smaller
-	for (unsigned int i = 0 ; i < pop_lim ; i++) {
+	// Prints N or the current pop size, which ever is smaller -- By rank
+	const uint32_t *const rank = GeneticAlgorithm::get_rank ();
+
+	for (unsigned int r = 0 ; r < pop_lim ; r++) {
+		GeneticAlgorithm &target = indv [rank[r]];
+
 		fprintf (rpt, "%7u | %3u | %7u | %4u | ",
-			indv[i].get_uid(), indv[i].get_sol(),
-			indv[i].get_fit(), indv[i].get_gate()
+			target.get_uid(), target.get_sol(),
+			target.get_fit(), target.get_gate()
 		);
 
-		indv[i].fprint_dna (rpt, dna_length);
+		target.fprint_dna (rpt, dna_length);
 		fputc ('\n', rpt);
 	}
 
@@ -673,11 +1110,13 @@ void data_dump (GeneticAlgorithm *const array, const unsigned int &gen) {
 	// Append next line
 	fp = fopen (filename, "a");
 
-	// Dump gen number and all genetic information
+	// Dump gen number and all genetic information -- By rank
+	const uint32_t *const rank = GeneticAlgorithm::get_rank ();
+
 	fprintf (fp, "%d,", gen);
 	for (unsigned int i = 0 ; i < pop_lim ; i++) {
 		fprintf (fp, "'");
-		array[i].fprint_dna (fp, dna_length);
+		array[rank[i]].fprint_dna (fp, dna_length);
 		fprintf (fp, "',");
 	}
 	fprintf (fp, "\n");
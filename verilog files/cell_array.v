@@ -144,11 +144,17 @@ module cell_array
     
 // ========== Avalon Slave Port S3 ============ //
 
-    // S2 Write Enable
+    // S3 Write Enable
     input wire  s3_write,
 
-    // S2 Write Data
-    input wire  [COUNTER_BIT-1 : 0] s3_writedata
+    // S3 Write Data
+    input wire  [COUNTER_BIT-1 : 0] s3_writedata,
+
+    // S3 Read Enable
+    input wire  s3_read,
+
+    // S3 Read Data | Remaining clock count, zero once the Cell Array has finished running
+    output reg  [COUNTER_BIT-1 : 0] s3_readdata
     
     
 );
@@ -219,6 +225,11 @@ module cell_array
         Can control precisely how many clock cycles to run.
     */
     wire    clk_out;
+
+    /* Wind-up clock status
+        Remaining clock count, read through s3_readdata.
+    */
+    wire    [COUNTER_BIT-1 : 0] clk_remaining;
     
     
 // =================================================================== //
@@ -307,8 +318,23 @@ module cell_array
         .rst        ( rst ),
         .wr_en      ( s3_write ),
         .wind       ( s3_writedata ),
-        .clk_out    ( clk_out )
+        .clk_out    ( clk_out ),
+        .remaining  ( clk_remaining )
     );
+
+    always @ (posedge s3_read or posedge rst) begin
+
+        // s3_readdata <= remaining clock count
+        if (s3_read == 1'b1) begin
+            s3_readdata <= clk_remaining;
+        end
+
+        // Reset
+        if (rst == 1'b1) begin
+            s3_readdata <= 0;
+        end
+
+    end
     
     
 endmodule
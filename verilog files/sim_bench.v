@@ -30,6 +30,8 @@ module sim_bench;
 
 	reg	s3_write = 1'b0;
 	reg	[15 : 0]	s3_writedata = 16'd100;
+	reg	s3_read = 1'b0;
+	wire	[15 : 0]	s3_readdata;
 	
 	initial
 		begin : test_loop
@@ -94,8 +96,20 @@ module sim_bench;
 		#10
 		s3_write = 0;
 		
-		$display ("\n--- WAIT 5000 ---\n");
-		#5000
+		$display ("\n--- Poll S3 Until Done ---\n");
+		#10
+		s3_read = 1;
+		#10
+		s3_read = 0;
+		
+		while (s3_readdata != 0) begin
+			#10
+			s3_read = 1;
+			#10
+			s3_read = 0;
+		end
+		
+		$display (" %6d | S3 : Done", $time);
 		
 		// -- END --
 		$display ("\n--- END ---\n");
@@ -126,7 +140,9 @@ module sim_bench;
 		.s2_address		( s2_address ),
 		.s2_writedata	( s2_writedata ),
 		.s3_write		( s3_write ),
-		.s3_writedata	( s3_writedata )
+		.s3_writedata	( s3_writedata ),
+		.s3_read		( s3_read ),
+		.s3_readdata	( s3_readdata )
 	);
 	
 	
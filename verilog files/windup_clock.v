@@ -3,6 +3,9 @@
     Filters clock signal, outputs the specified number of clock pulses.
     Analogous to a wind-up clock,
 
+    The remaining count is exposed as a status output, reaching zero once every pulse is out.
+    Polled by the HPS to know when the Cell Array has finished running.
+
     Repo: https://github.com/mimocha/verilog-library
     Copyright (c) 2018 Chawit Leosrisook
 */
@@ -27,7 +30,8 @@ module windup_clock
     input wire          rst,
     input wire          wr_en,
     input wire  [BIT-1 : 0] wind,
-    output wire         clk_out
+    output wire         clk_out,
+    output wire [BIT-1 : 0] remaining
 );
 
 //=========================================================================
@@ -39,6 +43,9 @@ reg [BIT-1 : 0] counter;
 // While any counter bit is high && wr_en is low, let CLK signal through.
 assign clk_out = clk_in & |counter & ~wr_en;
 
+// Status -- Counter value, zero once it has run down
+assign remaining = counter;
+
 
 always @ (posedge clk_in or posedge wr_en or posedge rst) begin
 